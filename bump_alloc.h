@@ -2,28 +2,238 @@
 #define GLOBAL_BUMP_ALLOC_H
 
 
+// @NOTE: need to define BUMP_ALLOC_IMPLEMENTATION once before including 
+//        #define BUMP_ALLOC_IMPLEMENTATION
+//        #include "bump_alloc.h"
 
 #include "global.h"
 
+#include <stddef.h>   // max_align_t
+#include <stdint.h>   // uintptr_t
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// @DOC: header in front of every block of a growable bump_alloc_t
+//       blocks get chained via prev, newest block is alloc->block
+//       blocks after alloc->block were unchained by bump_rewind() and get reused by bump_add_block()
+typedef struct bump_block_t
+{
+  struct bump_block_t* prev;  // previous, already full block, NULL if first
+  struct bump_block_t* next;  // next block, NULL if none, only in use if alloc->block is after this
+  u64 size;                   // size of data after header
+  u64 total;                  // size of this and all previous blocks, total_size while this is alloc->block
+}bump_block_t;
+
+// @DOC: define BUMP_ALLOC_STATS globally (-DBUMP_ALLOC_STATS) to track allocation statistics
+//       per arena, print them with P_BUMP_STATS()
+#ifdef BUMP_ALLOC_STATS
+
+// @DOC: how many different bump_alloc() call sites get tracked per arena
+#ifndef BUMP_ALLOC_STATS_MAX_SITES
+#define BUMP_ALLOC_STATS_MAX_SITES 64
+#endif
+
+// @DOC: allocations made from one bump_alloc() call site
+typedef struct
+{
+  const char* file;           // NULL if unused
+  int         line;
+  u64         count;
+  u64         bytes;
+}bump_stats_site_t;
+
+typedef struct
+{
+  u64 alloc_count;            // calls to bump_alloc() since init
+  u64 bytes_requested;        // size passed to bump_alloc() since init
+  u64 bytes_wasted;           // padding for alignment since init
+  u64 peak;                   // highest used since init
+  u64 peak_since_reset;       // highest used since last bump_reset()
+  u64 reset_count;
+  u64 sites_dropped;          // allocations from call sites that didnt fit in sites
+  bump_stats_site_t sites[BUMP_ALLOC_STATS_MAX_SITES];
+}bump_stats_t;
+
+#endif // BUMP_ALLOC_STATS
+
 typedef struct
 {
   u8* data;
-  u32 size;
-  u32 pos;
+  u64 size;
+  u64 pos;
+  u64 last_pos;               // pos before the last bump_alloc(), used by bump_pop()
+  u64 last_start;             // where the last bump_alloc() starts, after padding, BUMP_NO_LAST if it was undone
+
+  // @DOC: only used in growable mode, see bump_init_growable()
+  bool growable;
+  u64  max_size;              // cap for size of all blocks combined, 0 is no cap
+  u64  total_size;            // size of all blocks combined
+  bump_block_t* block;        // current block, data points right after it
+
+  // @DOC: only used in virtual memory mode, see bump_init_vmem()
+  bool vmem;
+  u32  vmem_flags;            // bump_vmem_flags
+  u64  committed;             // bytes from data that are backed by memory
+
+#ifdef BUMP_ALLOC_STATS
+  bump_stats_t stats;
+#endif
 
 }bump_alloc_t;
 
+// @DOC: flags for bump_init_vmem()
+typedef enum bump_vmem_flags
+{
+  BUMP_VMEM_NONE      = 0,
+  BUMP_VMEM_HUGEPAGES = FLAG(0),  // transparent huge pages via madvise(), linux only
+  BUMP_VMEM_HUGETLB   = FLAG(1),  // explicit huge pages via MAP_HUGETLB, linux only, falls back to normal pages
+}bump_vmem_flags;
+
+// @DOC: alignment of types, used in BUMP_ALLOC_TYPE() / BUMP_ALLOC_ARRAY()
+//       c99 has no _Alignof / max_align_t, there the offset of the type after a char is its alignment
+#if defined(__cplusplus)
+  #define BUMP_ALIGNOF(_type) alignof(_type)
+  #define BUMP_MAX_ALIGN      alignof(max_align_t)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+  #define BUMP_ALIGNOF(_type) _Alignof(_type)
+  #define BUMP_MAX_ALIGN      _Alignof(max_align_t)
+#else
+  #define BUMP_ALIGNOF(_type) offsetof(struct { char c; _type t; }, t)
+  #define BUMP_MAX_ALIGN      16
+#endif
+// @DOC: alignment used by bump_alloc(), can be defined before including
+#ifndef BUMP_ALLOC_DEFAULT_ALIGN
+#define BUMP_ALLOC_DEFAULT_ALIGN BUMP_MAX_ALIGN
+#endif
+
+// @DOC: how much bigger each new block is than the last in growable mode
+#ifndef BUMP_ALLOC_GROWTH_FACTOR
+#define BUMP_ALLOC_GROWTH_FACTOR 2
+#endif
+
+// @DOC: how much memory gets committed at once in virtual memory mode
+//       needs to be multiple of the page size
+#ifndef BUMP_VMEM_COMMIT_SIZE
+#define BUMP_VMEM_COMMIT_SIZE    (64 * 1024)
+#endif
+// @DOC: same as BUMP_VMEM_COMMIT_SIZE, but with BUMP_VMEM_HUGEPAGES / BUMP_VMEM_HUGETLB
+#ifndef BUMP_VMEM_HUGEPAGE_SIZE
+#define BUMP_VMEM_HUGEPAGE_SIZE  (2 * 1024 * 1024)
+#endif
+#define BUMP_VMEM_GRANULARITY(_flags)  (HAS_FLAG(_flags, BUMP_VMEM_HUGEPAGES | BUMP_VMEM_HUGETLB) ? BUMP_VMEM_HUGEPAGE_SIZE : BUMP_VMEM_COMMIT_SIZE)
+
+// @DOC: value of last_start if there is no last allocation bump_resize_last() could resize
+#define BUMP_NO_LAST ((u64)-1)
+
+// @DOC: bytes used in the arena, in growable mode includes the whole size of all previous blocks
+#define BUMP_USED(_alloc)  ((_alloc)->total_size - (_alloc)->size + (_alloc)->pos)
+
+#ifdef BUMP_ALLOC_STATS
+
+// @DOC: record an allocation in alloc->stats, called by bump_alloc()
+INLINE void bump_stats_record(bump_alloc_t* alloc, u64 size, u64 pad, const char* _file, const int _line)
+{
+  bump_stats_t* stats = &alloc->stats;
+  stats->alloc_count++;
+  stats->bytes_requested += size;
+  stats->bytes_wasted    += pad;
+
+  u64 used = BUMP_USED(alloc);
+  if (used > stats->peak)             { stats->peak = used; }
+  if (used > stats->peak_since_reset) { stats->peak_since_reset = used; }
+
+  // open addressing on file pointer and line, __FILE__ is the same literal for every call from one site
+  u32 hash = (u32)(((uintptr_t)_file >> 3) ^ ((u32)_line * 2654435761u));
+  for (u32 i = 0; i < BUMP_ALLOC_STATS_MAX_SITES; ++i)
+  {
+    bump_stats_site_t* site = &stats->sites[(hash + i) % BUMP_ALLOC_STATS_MAX_SITES];
+    if (site->file == NULL)
+    {
+      site->file = _file;
+      site->line = _line;
+    }
+    if (site->file == _file && site->line == _line)
+    {
+      site->count++;
+      site->bytes += size;
+      return;
+    }
+  }
+  stats->sites_dropped++;
+}
+
+// @DOC: record a bump_resize_last() in alloc->stats, the size difference counts as requested
+INLINE void bump_stats_resize(bump_alloc_t* alloc, u64 old_size, u64 new_size)
+{
+  bump_stats_t* stats = &alloc->stats;
+  stats->bytes_requested += new_size - old_size;  // unsigned, wraps back when shrinking
+
+  u64 used = BUMP_USED(alloc);
+  if (used > stats->peak)             { stats->peak = used; }
+  if (used > stats->peak_since_reset) { stats->peak_since_reset = used; }
+}
+
+// @DOC: print the stats of a bump allocator
+//       P_BUMP_STATS(&alloc);
+#define P_BUMP_STATS(_alloc) bump_stats_print(_alloc, #_alloc, __FILE__, __func__, __LINE__)
+INLINE void bump_stats_print(bump_alloc_t* alloc, const char* name, const char* _file, const char* _func, const int _line)
+{
+  bump_stats_t* stats = &alloc->stats;
+  _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ":\n"
+      "  size:             %" PRIu64 "\n"
+      "  used:             %" PRIu64 "\n"
+      "  peak:             %" PRIu64 "\n"
+      "  peak since reset: %" PRIu64 "\n"
+      "  allocs:           %" PRIu64 "\n"
+      "  bytes requested:  %" PRIu64 "\n"
+      "  bytes wasted:     %" PRIu64 "\n"
+      "  resets:           %" PRIu64 "\n"
+      "  call sites:\n",
+      name, alloc->total_size, BUMP_USED(alloc), stats->peak, stats->peak_since_reset,
+      stats->alloc_count, stats->bytes_requested, stats->bytes_wasted, stats->reset_count);
+  for (u32 i = 0; i < BUMP_ALLOC_STATS_MAX_SITES; ++i)
+  {
+    bump_stats_site_t* site = &stats->sites[i];
+    if (site->file == NULL) { continue; }
+    _PF("    %s, line: %d -> allocs: %" PRIu64 ", bytes: %" PRIu64 "\n", site->file, site->line, site->count, site->bytes);
+  }
+  if (stats->sites_dropped > 0)
+  { _PF("    %" PRIu64 " allocs from untracked call sites, increase BUMP_ALLOC_STATS_MAX_SITES\n", stats->sites_dropped); }
+  _PF_IF_LOC(_file, _func, _line);
+  (void)stats; (void)name; (void)_file; (void)_func; (void)_line;
+}
+
+#define BUMP_STATS_INIT(_alloc)                               memset(&(_alloc)->stats, 0, sizeof(bump_stats_t))
+#define BUMP_STATS_RECORD(_alloc, _size, _pad, _file, _line)  bump_stats_record(_alloc, _size, _pad, _file, _line)
+#define BUMP_STATS_RESIZE(_alloc, _old_size, _new_size)       bump_stats_resize(_alloc, _old_size, _new_size)
+#define BUMP_STATS_RESET(_alloc)                              do { (_alloc)->stats.peak_since_reset = 0; (_alloc)->stats.reset_count++; } while (0)
+
+#else  // BUMP_ALLOC_STATS
+
+#define P_BUMP_STATS(_alloc)
+#define BUMP_STATS_INIT(_alloc)
+#define BUMP_STATS_RECORD(_alloc, _size, _pad, _file, _line)
+#define BUMP_STATS_RESIZE(_alloc, _old_size, _new_size)
+#define BUMP_STATS_RESET(_alloc)
+
+#endif // BUMP_ALLOC_STATS
+
+// @DOC: os specific virtual memory functions, defined in BUMP_ALLOC_IMPLEMENTATION
+//       reserve: reserve address space without backing memory, returns NULL on fail
+//       commit:  back range of reserved space with read-/writable memory
+//       release: give back whole reserved space
+u8*  bump_vmem_reserve(u64 size, u32 flags);
+bool bump_vmem_commit(u8* ptr, u64 size);
+void bump_vmem_release(u8* ptr, u64 size);
+
 
 // @DOC: initializes bump_allocator to specified size
 //       ! needs to be free'd using bump_free()
 //       reset for reusage using bump_reset()
 #define bump_init(_alloc, _size) bump_init_dbg(_alloc, _size, __FILE__, __LINE__)
-INLINE void bump_init_dbg(bump_alloc_t* alloc, u32 size, const char* _file, const int _line)
+INLINE void bump_init_dbg(bump_alloc_t* alloc, u64 size, const char* _file, const int _line)
 {
   TRACE();
 
@@ -32,40 +242,364 @@ INLINE void bump_init_dbg(bump_alloc_t* alloc, u32 size, const char* _file, cons
   ERR_CHECK(size > 0,            "size needs to be bigger than 0\n\t->file. %s, line: %d\n", _file, _line);
   (void)_file; (void)_line;
 
-  MALLOC(alloc->data, size);
-  alloc->size = size;
-  alloc->pos  = 0;
+  void* mem = NULL;
+  MALLOC(mem, size);
+  alloc->data = (u8*)mem;
+  alloc->size     = size;
+  alloc->pos        = 0;
+  alloc->last_pos   = 0;
+  alloc->last_start = BUMP_NO_LAST;
+
+  alloc->growable   = false;
+  alloc->max_size   = 0;
+  alloc->total_size = size;
+  alloc->block      = NULL;
+
+  alloc->vmem       = false;
+  alloc->vmem_flags = BUMP_VMEM_NONE;
+  alloc->committed  = size;
+
+  BUMP_STATS_INIT(alloc);
 }
 
-// @DOC: returns pointer to memory in pre-allocated bump-memory
+// @DOC: initializes bump_allocator in virtual memory mode
+//       reserves size bytes of address space, but only commits memory as pos grows,
+//       so huge arenas start instantly and only use as much memory as is actually allocated
+//       size:  gets rounded up to BUMP_VMEM_GRANULARITY()
+//       flags: bump_vmem_flags, i.e. BUMP_VMEM_HUGEPAGES for fewer tlb misses on big arenas
+//       ! needs to be free'd using bump_free()
+//       bump_reset() keeps the committed memory
+#define bump_init_vmem(_alloc, _size, _flags) bump_init_vmem_dbg(_alloc, _size, _flags, __FILE__, __LINE__)
+INLINE void bump_init_vmem_dbg(bump_alloc_t* alloc, u64 size, u32 flags, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->data == NULL, "alloc->data isnt null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(size > 0,            "size needs to be bigger than 0\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  u64 granularity = BUMP_VMEM_GRANULARITY(flags);
+  size = (size + granularity -1) & ~(granularity -1);
+
+  alloc->data = bump_vmem_reserve(size, flags);
+  ERR_CHECK(alloc->data != NULL, "failed to reserve %" PRIu64 " bytes of address space\n\t->file. %s, line: %d\n", size, _file, _line);
+  alloc->size     = size;
+  alloc->pos        = 0;
+  alloc->last_pos   = 0;
+  alloc->last_start = BUMP_NO_LAST;
+
+  alloc->growable   = false;
+  alloc->max_size   = 0;
+  alloc->total_size = size;
+  alloc->block      = NULL;
+
+  alloc->vmem       = true;
+  alloc->vmem_flags = flags;
+  alloc->committed  = 0;
+
+  BUMP_STATS_INIT(alloc);
+}
+
+// @DOC: commit memory in virtual memory mode, so at least end bytes from data are usable
+INLINE void bump_vmem_commit_to(bump_alloc_t* alloc, u64 end, const char* _file, const int _line)
+{
+  u64 granularity = BUMP_VMEM_GRANULARITY(alloc->vmem_flags);
+  u64 committed   = (end + granularity -1) & ~(granularity -1);
+  if (committed > alloc->size) { committed = alloc->size; }
+
+  bool ok = bump_vmem_commit(alloc->data + alloc->committed, committed - alloc->committed);
+  ERR_CHECK(ok, "failed to commit %" PRIu64 " bytes\n\t->file. %s, line: %d\n", committed - alloc->committed, _file, _line);
+  (void)ok; (void)_file; (void)_line;
+  alloc->committed = committed;
+}
+
+// @DOC: free block and all blocks after it
+INLINE void __bump_free_blocks(bump_block_t* block)
+{
+  while (block != NULL)
+  {
+    bump_block_t* next = block->next;
+    FREE(block);
+    block = next;
+  }
+}
+
+// @DOC: chains a block in front of the current one, used in growable mode
+//       reuses the block bump_rewind() left after the current one if its at least size,
+//       otherwise frees those and allocates a new one
+//       size: size of the new block
+//       returns false if max_size would be exceeded
+INLINE bool bump_add_block(bump_alloc_t* alloc, u64 size)
+{
+  bump_block_t* block = alloc->block != NULL ? alloc->block->next : NULL;
+  if (block != NULL && (block->size < size || (alloc->max_size > 0 && alloc->total_size + block->size > alloc->max_size)))
+  {
+    __bump_free_blocks(block);
+    alloc->block->next = NULL;
+    block = NULL;
+  }
+  if (block == NULL)
+  {
+    if (alloc->max_size > 0)
+    {
+      if (alloc->total_size + size > alloc->max_size || alloc->total_size + size < size) { return false; }
+    }
+    void* mem = NULL;
+    MALLOC(mem, sizeof(bump_block_t) + size);
+    block = (bump_block_t*)mem;
+    block->next = NULL;
+    block->size = size;
+    if (alloc->block != NULL) { alloc->block->next = block; }
+  }
+  block->prev  = alloc->block;
+  block->total = alloc->total_size + block->size;
+
+  alloc->block      = block;
+  alloc->data       = (u8*)(block + 1);
+  alloc->size       = block->size;
+  alloc->pos        = 0;
+  alloc->last_pos   = 0;
+  alloc->last_start = BUMP_NO_LAST;
+  alloc->total_size = block->total;
+  return true;
+}
+
+// @DOC: initializes bump_allocator to specified size, in growable mode
+//       instead of running out of memory new blocks get chained on,
+//       each BUMP_ALLOC_GROWTH_FACTOR times bigger than the last
+//       bump_reset() keeps the largest block and frees the rest
+//       max_size: cap for all blocks combined, 0 for no cap
+//       ! needs to be free'd using bump_free()
+#define bump_init_growable(_alloc, _size, _max_size) bump_init_growable_dbg(_alloc, _size, _max_size, __FILE__, __LINE__)
+INLINE void bump_init_growable_dbg(bump_alloc_t* alloc, u64 size, u64 max_size, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->data == NULL, "alloc->data isnt null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(size > 0,            "size needs to be bigger than 0\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(max_size == 0 || max_size >= size, "max_size needs to be 0 or at least size\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  alloc->growable   = true;
+  alloc->max_size   = max_size;
+  alloc->total_size = 0;
+  alloc->block      = NULL;
+
+  alloc->vmem       = false;
+  alloc->vmem_flags = BUMP_VMEM_NONE;
+  alloc->committed  = 0;
+
+  bump_add_block(alloc, size);
+
+  BUMP_STATS_INIT(alloc);
+}
+
+// @DOC: returns pointer to memory in pre-allocated bump-memory, aligned to align bytes
+//       align: needs to be power of 2, e.g. 16/32/64 for simd types
 //       ! need to call bump_init() first
 //       reset for reusage using bump_reset()
-#define bump_alloc(_alloc, _size) bump_alloc_dbg(_alloc, _size, __FILE__, __LINE__)
-INLINE void* bump_alloc_dbg(bump_alloc_t* alloc, u32 size, const char* _file, const int _line)
+#define bump_alloc_aligned(_alloc, _size, _align) bump_alloc_aligned_dbg(_alloc, _size, _align, __FILE__, __LINE__)
+INLINE void* bump_alloc_aligned_dbg(bump_alloc_t* alloc, u64 size, u32 align, const char* _file, const int _line)
 {
   TRACE();
 
   ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
   ERR_CHECK(alloc->data != NULL, "alloc->data is null pointer, call bump_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(align > 0 && (align & (align -1)) == 0, "align needs to be a power of 2, is: %u\n\t->file. %s, line: %d\n", align, _file, _line);
 
-  if (alloc->pos + size < alloc->size)
+  // padding needed to align the address, not the offset, blocks arent aligned to more than malloc() gives
+  // compared against whats left, so huge sizes cant wrap around
+  u64 pad = (u64)(-(uintptr_t)&alloc->data[alloc->pos] & (uintptr_t)(align -1));
+  if (pad <= alloc->size - alloc->pos && size <= alloc->size - alloc->pos - pad)
   {
+    if (alloc->vmem && alloc->pos + pad + size > alloc->committed)
+    { bump_vmem_commit_to(alloc, alloc->pos + pad + size, _file, _line); }
     // @UNSURE: set memory to 0
-    alloc->pos += size;
-    return &alloc->data[alloc->pos];
+    void* ptr = &alloc->data[alloc->pos + pad];
+    alloc->last_pos   = alloc->pos;
+    alloc->last_start = alloc->pos + pad;
+    alloc->pos       += pad + size;
+    BUMP_STATS_RECORD(alloc, size, pad, _file, _line);
+    return ptr;
+  }
+  if (alloc->growable && size <= (u64)-1 - align - sizeof(bump_block_t))
+  {
+    // worst case padding, so the allocation fits no matter the blocks alignment
+    u64 needed     = size + align -1;
+    u64 block_size = alloc->size * BUMP_ALLOC_GROWTH_FACTOR;
+    if (block_size < needed || block_size / BUMP_ALLOC_GROWTH_FACTOR != alloc->size) { block_size = needed; }
+    // clamp to cap, but still try to fit the allocation
+    if (alloc->max_size > 0 && alloc->total_size + block_size > alloc->max_size && 
+        alloc->max_size - alloc->total_size >= needed)
+    { block_size = alloc->max_size - alloc->total_size; }
+
+    if (bump_add_block(alloc, block_size))
+    {
+      pad = (u64)(-(uintptr_t)alloc->data & (uintptr_t)(align -1));
+      void* ptr = &alloc->data[pad];
+      alloc->last_pos   = 0;
+      alloc->last_start = pad;
+      alloc->pos        = pad + size;
+      BUMP_STATS_RECORD(alloc, size, pad, _file, _line);
+      return ptr;
+    }
   }
-  // @TODO: handle this 
   ERR("bump_alloc ran out of memory\n\t->file. %s, line: %d\n", _file, _line);
   (void)_file; (void)_line;
   return NULL;
 }
 
-// @TODO: make bump_walk_back() etc. func for walking back last alloc
+// @DOC: returns pointer to memory in pre-allocated bump-memory, aligned to BUMP_ALLOC_DEFAULT_ALIGN
+//       ! need to call bump_init() first
+//       reset for reusage using bump_reset()
+#define bump_alloc(_alloc, _size) bump_alloc_dbg(_alloc, _size, __FILE__, __LINE__)
+INLINE void* bump_alloc_dbg(bump_alloc_t* alloc, u64 size, const char* _file, const int _line)
+{
+  return bump_alloc_aligned_dbg(alloc, size, BUMP_ALLOC_DEFAULT_ALIGN, _file, _line);
+}
+
+// @DOC: thread safe version of bump_alloc_aligned(), any amount of threads can allocate from the same arena
+//       lock-free, a compare-and-swap loop on pos, retries only if another thread allocated in between
+//       failed allocations dont move pos, so the arena never loses space
+//       ! only for arenas from bump_init(), not growable or virtual memory ones
+//       ! dont mix with bump_alloc(), bump_pop(), etc. while other threads allocate
+//       ! returns NULL instead of calling ERR() when out of memory, as other threads might still be fine
+//       ! isnt tracked by BUMP_ALLOC_STATS
+#define bump_alloc_atomic_aligned(_alloc, _size, _align) bump_alloc_atomic_aligned_dbg(_alloc, _size, _align, __FILE__, __LINE__)
+INLINE void* bump_alloc_atomic_aligned_dbg(bump_alloc_t* alloc, u64 size, u32 align, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->data != NULL, "alloc->data is null pointer, call bump_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(!alloc->growable,    "bump_alloc_atomic() doesnt support growable arenas\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(!alloc->vmem,        "bump_alloc_atomic() doesnt support virtual memory arenas\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(align > 0 && (align & (align -1)) == 0, "align needs to be a power of 2, is: %u\n\t->file. %s, line: %d\n", align, _file, _line);
+  (void)_file; (void)_line;
+
+  // padding is exact for the pos we try to claim, on failure ATOMIC_CAS() loads the new pos
+  u64 pos = ATOMIC_LOAD(&alloc->pos);
+  u64 pad;
+  do
+  {
+    pad = (u64)(-(uintptr_t)&alloc->data[pos] & (uintptr_t)(align -1));
+    if (pad > alloc->size - pos || size > alloc->size - pos - pad) { return NULL; }
+  } while (!ATOMIC_CAS(&alloc->pos, &pos, pos + pad + size));
+
+  return &alloc->data[pos + pad];
+}
+#define bump_alloc_atomic(_alloc, _size) bump_alloc_atomic_aligned_dbg(_alloc, _size, BUMP_ALLOC_DEFAULT_ALIGN, __FILE__, __LINE__)
+
+// @DOC: typed helpers, aligned to the types alignment
+//       my_struct_t* s   = BUMP_ALLOC_TYPE(&alloc, my_struct_t);
+//       f32*         arr = BUMP_ALLOC_ARRAY(&alloc, f32, 128);
+#define BUMP_ALLOC_TYPE(_alloc, _type)      ((_type*)bump_alloc_aligned((_alloc), (u64)sizeof(_type), (u32)BUMP_ALIGNOF(_type)))
+#define BUMP_ALLOC_ARRAY(_alloc, _type, _n) ((_type*)bump_alloc_aligned((_alloc), (u64)(sizeof(_type) * (_n)), (u32)BUMP_ALIGNOF(_type)))
+// @DOC: same as BUMP_ALLOC_ARRAY() but with explicit alignment, i.e. 32 for avx loads
+#define BUMP_ALLOC_ARRAY_ALIGNED(_alloc, _type, _n, _align) ((_type*)bump_alloc_aligned((_alloc), (u64)(sizeof(_type) * (_n)), (_align)))
+
+// @DOC: position in a bump allocator, returned by bump_mark() used by bump_rewind()
+typedef struct
+{
+  bump_block_t* block;        // block at time of marking, NULL if not growable
+  u64 pos;
+}bump_mark_t;
+
+// @DOC: get the current position of the bump allocator, to later go back to using bump_rewind()
+//       bump_mark_t m = bump_mark(&alloc);
+//       ... temporary allocations ...
+//       bump_rewind(&alloc, m);
+INLINE bump_mark_t bump_mark(bump_alloc_t* alloc)
+{
+  bump_mark_t mark;
+  mark.block = alloc->block;
+  mark.pos   = alloc->pos;
+  return mark;
+}
+
+// @DOC: walk back all allocations made since bump_mark()
+//       ! marks taken after this one are invalid afterwards
+//       O(1), in growable mode blocks chained on after the mark stay allocated
+//       and get reused by the next blocks, bump_reset() / bump_free() free them
+//       with GLOBAL_DEBUG the mark gets checked against the chain, which is O(blocks)
+#define bump_rewind(_alloc, _mark) bump_rewind_dbg(_alloc, _mark, __FILE__, __LINE__)
+INLINE void bump_rewind_dbg(bump_alloc_t* alloc, bump_mark_t mark, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL, "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  bool other_block = alloc->block != mark.block;
+  if (other_block)
+  {
+  #ifdef GLOBAL_DEBUG
+    bump_block_t* b = alloc->block;
+    while (b != NULL && b != mark.block) { b = b->prev; }
+    ERR_CHECK(b != NULL, "mark isnt from this allocator or was rewound past\n\t->file. %s, line: %d\n", _file, _line);
+  #endif
+    ERR_CHECK(mark.block != NULL, "mark isnt from this allocator\n\t->file. %s, line: %d\n", _file, _line);
+    alloc->block      = mark.block;
+    alloc->data       = (u8*)(mark.block + 1);
+    alloc->size       = mark.block->size;
+    alloc->total_size = mark.block->total;
+  }
+  ERR_CHECK(other_block || mark.pos <= alloc->pos, "mark is ahead of allocator, was rewound past\n\t->file. %s, line: %d\n", _file, _line);
+  alloc->pos        = mark.pos;
+  alloc->last_pos   = mark.pos;
+  alloc->last_start = BUMP_NO_LAST;
+}
+
+// @DOC: walk back the last bump_alloc(), only works once per allocation
+//       void* tmp = bump_alloc(&alloc, 64);
+//       bump_pop(&alloc);   // tmp is invalid now
+#define bump_pop(_alloc) bump_pop_dbg(_alloc, __FILE__, __LINE__)
+INLINE void bump_pop_dbg(bump_alloc_t* alloc, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL, "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+  alloc->pos        = alloc->last_pos;
+  alloc->last_start = BUMP_NO_LAST;
+}
+
+// @DOC: grow or shrink the last allocation in place, ptr needs to be what the last bump_alloc() returned
+//       returns false if ptr isnt the start of the last allocation, that was undone by bump_pop() / bump_rewind(),
+//       or size doesnt fit in the current block,
+//       then nothing changes and ptr stays valid
+//       char* buf = bump_alloc(&alloc, 64);
+//       if (!bump_resize_last(&alloc, buf, 128)) { ... allocate new buffer and copy ... }
+#define bump_resize_last(_alloc, _ptr, _size) bump_resize_last_dbg(_alloc, _ptr, _size, __FILE__, __LINE__)
+INLINE bool bump_resize_last_dbg(bump_alloc_t* alloc, void* ptr, u64 size, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->data != NULL, "alloc->data is null pointer, call bump_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  // last allocation starts at last_start and ends at pos
+  u64 start = alloc->last_start;
+  if (start == BUMP_NO_LAST || (u8*)ptr != &alloc->data[start]) { return false; }
+  if (size > alloc->size - start) { return false; }
+
+  if (alloc->vmem && start + size > alloc->committed)
+  { bump_vmem_commit_to(alloc, start + size, _file, _line); }
+  u64 old_size = alloc->pos - start;
+  alloc->pos   = start + size;
+  BUMP_STATS_RESIZE(alloc, old_size, size);
+  (void)old_size;
+  return true;
+}
 
 
 // @DOC: reset the bump allocator for reusage
 //       ! doesnt free just resets to be overwritten by next bump_alloc()
 //       ! use bump_free() to actually free
+//       in growable mode keeps the largest block and frees the rest, including ones left by bump_rewind()
 #define bump_reset(_alloc) bump_reset_dbg(_alloc, __FILE__, __LINE__)
 INLINE void bump_reset_dbg(bump_alloc_t* alloc, const char* _file, const int _line)
 {
@@ -73,7 +607,35 @@ INLINE void bump_reset_dbg(bump_alloc_t* alloc, const char* _file, const int _li
 
   ERR_CHECK(alloc != NULL, "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
   (void)_file; (void)_line;
-  alloc->pos = 0;
+  alloc->pos        = 0;
+  alloc->last_pos   = 0;
+  alloc->last_start = BUMP_NO_LAST;
+  BUMP_STATS_RESET(alloc);
+
+  if (alloc->growable && alloc->block != NULL && (alloc->block->prev != NULL || alloc->block->next != NULL))
+  {
+    bump_block_t* first = alloc->block;
+    while (first->prev != NULL) { first = first->prev; }
+    bump_block_t* largest = first;
+    for (bump_block_t* b = first->next; b != NULL; b = b->next)
+    {
+      if (b->size > largest->size) { largest = b; }
+    }
+    bump_block_t* b = first;
+    while (b != NULL)
+    {
+      bump_block_t* next = b->next;
+      if (b != largest) { FREE(b); }
+      b = next;
+    }
+    largest->prev     = NULL;
+    largest->next     = NULL;
+    largest->total    = largest->size;
+    alloc->block      = largest;
+    alloc->data       = (u8*)(largest + 1);
+    alloc->size       = largest->size;
+    alloc->total_size = largest->size;
+  }
 }
 
 
@@ -90,14 +652,290 @@ INLINE void bump_free_dbg(bump_alloc_t* alloc, const char* _file, const int _lin
   ERR_CHECK(alloc->data != NULL, "alloc->data is null pointer, call bump_init() first\n\t->file. %s, line: %d\n", _file, _line);
   (void)_file; (void)_line;
 
-  FREE(alloc->data);
-  alloc->data = NULL;
-  alloc->size = 0;
-  alloc->pos  = 0;
+  if (alloc->growable)
+  {
+    bump_block_t* first = alloc->block;
+    while (first != NULL && first->prev != NULL) { first = first->prev; }
+    __bump_free_blocks(first);
+    alloc->block = NULL;
+  }
+  else if (alloc->vmem)
+  {
+    bump_vmem_release(alloc->data, alloc->size);
+    alloc->vmem      = false;
+    alloc->committed = 0;
+  }
+  else
+  {
+    FREE(alloc->data);
+  }
+  alloc->data       = NULL;
+  alloc->size       = 0;
+  alloc->pos        = 0;
+  alloc->last_pos   = 0;
+  alloc->last_start = BUMP_NO_LAST;
+  alloc->total_size = 0;
 }
 
+// -- scratch --
+
+// @DOC: thread local scratch arenas, growable bump_alloc_t's each thread has its own of
+//       initialized on first use, no need to pass arenas through the call chain
+//       BUMP_SCRATCH_COUNT: how many scratch arenas per thread
+//       BUMP_SCRATCH_SIZE:  size of first block of each scratch arena
+#ifndef BUMP_SCRATCH_COUNT
+#define BUMP_SCRATCH_COUNT 2
+#endif
+#ifndef BUMP_SCRATCH_SIZE
+#define BUMP_SCRATCH_SIZE  (64 * 1024)
+#endif
+
+// @DOC: scratch arena with the position it had when it was taken, see bump_scratch_begin()
+typedef struct
+{
+  bump_alloc_t* alloc;
+  bump_mark_t   mark;
+}bump_scratch_t;
+
+// @DOC: get a scratch arena of the calling thread, that isnt one of the conflicts
+//       conflicts: arenas already in use, e.g. the arena passed in for the output
+//                  can be NULL if conflict_count is 0
+//       void func(bump_alloc_t* out)
+//       {
+//         bump_alloc_t* tmp = bump_scratch_get(&out, 1);  // never the same as out
+//       }
+bump_alloc_t* bump_scratch_get(bump_alloc_t** conflicts, u32 conflict_count);
+// @DOC: bump_scratch_get() and bump_mark() in one, end with bump_scratch_end()
+//       bump_scratch_t s = bump_scratch_begin(&out, 1);
+//       ... bump_alloc(s.alloc, ...) ...
+//       bump_scratch_end(s);
+bump_scratch_t bump_scratch_begin(bump_alloc_t** conflicts, u32 conflict_count);
+// @DOC: walk back all allocations made in scratch since bump_scratch_begin()
+#define bump_scratch_end(_scratch) bump_rewind((_scratch).alloc, (_scratch).mark)
+// @DOC: reset all scratch arenas of the calling thread, i.e. at the end of a frame / request
+void bump_scratch_reset(void);
+// @DOC: free all scratch arenas of the calling thread
+//       threads that exit free theirs automatically, see __bump_scratch_release()
+void bump_scratch_free(void);
+
 #ifdef __cplusplus
 } // extern C
+
+// @DOC: rewinds the allocator to where it was when the scope was entered
+//       {
+//         bump_scope_t scope(&alloc);
+//         ... temporary allocations ...
+//       } // bump_rewind() called here
+struct bump_scope_t
+{
+  bump_alloc_t* alloc;
+  bump_mark_t   mark;
+
+  explicit bump_scope_t(bump_alloc_t* _alloc) : alloc(_alloc), mark(bump_mark(_alloc)) {}
+  ~bump_scope_t() { bump_rewind(alloc, mark); }
+
+  bump_scope_t(const bump_scope_t&)            = delete;
+  bump_scope_t& operator=(const bump_scope_t&) = delete;
+};
 #endif
 
 #endif  // GLOBAL_BUMP_ALLOC_H
+
+// @DOC: need to define this once before including 
+#ifdef BUMP_ALLOC_IMPLEMENTATION
+
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <pthread.h>
+  #include <sys/mman.h>
+  // hidden in strict -std=c.. modes, then private mappings of /dev/zero are used instead
+  #if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+    #define MAP_ANONYMOUS MAP_ANON
+  #endif
+  #ifndef MAP_ANONYMOUS
+    #include <fcntl.h>
+    #include <unistd.h>
+  #endif
+  #ifndef MAP_NORESERVE
+    #define MAP_NORESERVE 0
+  #endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+
+// @NOTE: large pages on windows need SeLockMemoryPrivilege and cant be committed lazily,
+//        so BUMP_VMEM_HUGEPAGES / BUMP_VMEM_HUGETLB are ignored
+u8* bump_vmem_reserve(u64 size, u32 flags)
+{
+  (void)flags;
+  return (u8*)VirtualAlloc(NULL, (SIZE_T)size, MEM_RESERVE, PAGE_NOACCESS);
+}
+bool bump_vmem_commit(u8* ptr, u64 size)
+{
+  return VirtualAlloc(ptr, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+}
+void bump_vmem_release(u8* ptr, u64 size)
+{
+  (void)size;
+  VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
+#else // _WIN32
+
+// @DOC: maps size bytes of inaccessible, zeroed memory
+static void* __bump_vmem_map(u64 size, int map_flags)
+{
+#ifdef MAP_ANONYMOUS
+  return mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | map_flags, -1, 0);
+#else
+  int fd = open("/dev/zero", O_RDWR);
+  if (fd < 0) { return MAP_FAILED; }
+  void* ptr = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | map_flags, fd, 0);
+  close(fd);
+  return ptr;
+#endif
+}
+
+u8* bump_vmem_reserve(u64 size, u32 flags)
+{
+  void* ptr = MAP_FAILED;
+#if defined(MAP_HUGETLB) && defined(MAP_ANONYMOUS)
+  // no MAP_NORESERVE, so it fails if not enough huge pages are available, instead of SIGBUS on first touch
+  if (HAS_FLAG(flags, BUMP_VMEM_HUGETLB))
+  { ptr = __bump_vmem_map(size, MAP_HUGETLB); }
+#endif
+  if (ptr == MAP_FAILED)
+  { ptr = __bump_vmem_map(size, MAP_NORESERVE); }
+  if (ptr == MAP_FAILED) { return NULL; }
+#ifdef MADV_HUGEPAGE
+  if (HAS_FLAG(flags, BUMP_VMEM_HUGEPAGES))
+  { madvise(ptr, size, MADV_HUGEPAGE); }
+#endif
+  (void)flags;
+  return (u8*)ptr;
+}
+bool bump_vmem_commit(u8* ptr, u64 size)
+{
+  // pages only get backed by memory on first touch, mprotect() just makes them usable
+  return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+}
+void bump_vmem_release(u8* ptr, u64 size)
+{
+  munmap(ptr, size);
+}
+
+#endif // _WIN32
+
+THREAD_LOCAL bump_alloc_t __bump_scratch_arenas__[BUMP_SCRATCH_COUNT];
+
+// @DOC: calls __bump_scratch_release() on thread exit, created on the first bump_scratch_get()
+#if defined(_WIN32)
+  // fiber local storage, unlike tls it has a callback on thread exit
+  #define BUMP_SCRATCH_KEY_T             DWORD
+  #define BUMP_SCRATCH_KEY_CREATE()      ((__bump_scratch_key__ = FlsAlloc(__bump_scratch_release)) != FLS_OUT_OF_INDEXES)
+  #define BUMP_SCRATCH_KEY_SET(_arenas)  FlsSetValue(__bump_scratch_key__, _arenas)
+#else
+  #define BUMP_SCRATCH_KEY_T             pthread_key_t
+  #define BUMP_SCRATCH_KEY_CREATE()      (pthread_key_create(&__bump_scratch_key__, __bump_scratch_release) == 0)
+  #define BUMP_SCRATCH_KEY_SET(_arenas)  pthread_setspecific(__bump_scratch_key__, _arenas)
+#endif
+BUMP_SCRATCH_KEY_T __bump_scratch_key__;
+u32                __bump_scratch_key_state__ = 0;   // 0: not created, 1: creating, 2: created, 3: failed
+
+// @DOC: called on thread exit with the threads __bump_scratch_arenas__, frees their blocks
+//       the main thread doesnt get this call, its memory goes with the process
+#if defined(_WIN32)
+static void WINAPI __bump_scratch_release(void* ptr)
+#else
+static void __bump_scratch_release(void* ptr)
+#endif
+{
+  bump_alloc_t* arenas = (bump_alloc_t*)ptr;
+  for (u32 i = 0; i < BUMP_SCRATCH_COUNT; ++i)
+  {
+    // not bump_free(), its TRACE() would give the exiting thread a new trace ring
+    bump_block_t* first = arenas[i].block;
+    while (first != NULL && first->prev != NULL) { first = first->prev; }
+    __bump_free_blocks(first);
+    memset(&arenas[i], 0, sizeof(bump_alloc_t));
+  }
+}
+
+// @DOC: make __bump_scratch_release() free the calling threads scratch arenas when it exits
+static void __bump_scratch_register(void)
+{
+  u32 state = 0;
+  if (ATOMIC_CAS(&__bump_scratch_key_state__, &state, 1))
+  { ATOMIC_STORE(&__bump_scratch_key_state__, BUMP_SCRATCH_KEY_CREATE() ? 2 : 3); }
+  // another thread is creating the key
+  while ((state = (u32)ATOMIC_LOAD(&__bump_scratch_key_state__)) == 1) {}
+  if (state == 2) { BUMP_SCRATCH_KEY_SET(__bump_scratch_arenas__); }
+}
+
+bump_alloc_t* bump_scratch_get(bump_alloc_t** conflicts, u32 conflict_count)
+{
+  TRACE();
+
+  for (u32 i = 0; i < BUMP_SCRATCH_COUNT; ++i)
+  {
+    bump_alloc_t* scratch = &__bump_scratch_arenas__[i];
+    bool conflict = false;
+    for (u32 c = 0; c < conflict_count; ++c)
+    {
+      if (conflicts[c] == scratch) { conflict = true; break; }
+    }
+    if (conflict) { continue; }
+
+    if (scratch->data == NULL)
+    {
+      bump_init_growable(scratch, BUMP_SCRATCH_SIZE, 0);
+      __bump_scratch_register();
+    }
+    return scratch;
+  }
+  ERR("all %d scratch arenas are in conflicts, increase BUMP_SCRATCH_COUNT\n", BUMP_SCRATCH_COUNT);
+  return NULL;
+}
+
+bump_scratch_t bump_scratch_begin(bump_alloc_t** conflicts, u32 conflict_count)
+{
+  TRACE();
+
+  bump_scratch_t scratch;
+  scratch.alloc = bump_scratch_get(conflicts, conflict_count);
+  scratch.mark  = bump_mark(scratch.alloc);
+  return scratch;
+}
+
+void bump_scratch_reset(void)
+{
+  TRACE();
+
+  for (u32 i = 0; i < BUMP_SCRATCH_COUNT; ++i)
+  {
+    if (__bump_scratch_arenas__[i].data != NULL)
+    { bump_reset(&__bump_scratch_arenas__[i]); }
+  }
+}
+
+void bump_scratch_free(void)
+{
+  TRACE();
+
+  for (u32 i = 0; i < BUMP_SCRATCH_COUNT; ++i)
+  {
+    if (__bump_scratch_arenas__[i].data != NULL)
+    { bump_free(&__bump_scratch_arenas__[i]); }
+  }
+}
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif  // BUMP_ALLOC_IMPLEMENTATION
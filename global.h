@@ -14,10 +14,14 @@
 // for printing macros, define globally:
 //  GLOBAL_DEBUG          (-DGLOBAL_DEBUG)                  : compile in/out P/PF/P_ macros
 //  PF_PRINT_LOCATION     (-DPF_PRINT_LOCATION)             : make P/PF/P_ macros print location
+//  PF_ASYNC              (-DPF_ASYNC)                      : P/PF/P_ macros print from a background thread
+//  PF_LOG_LEVELS         (-DPF_LOG_LEVELS)                 : runtime log levels per module, env var PF_LEVEL
+//  PF_STRUCTURED         (-DPF_STRUCTURED)                 : P_V/P_ macros can print json/binary, env var PF_OUTPUT / PF_OUTPUT_PATH
 // for tracing, define globally:
 //  TRACE_PRINT_LOCATION  (-DTRACE_PRINT_LOCATION)          : compile in TRACE macros
 //  TRACE_LOG_PATH        (-DTRACE_LOG_PATH=\"trace.log\")  : path/name of trace log file
-//  TRACE_LOG_MAX_LINES   (-DTRACE_LOG_MAX_LINES=20)        : max lines output to log file
+//  TRACE_LOG_MAX_LINES   (-DTRACE_LOG_MAX_LINES=20)        : max lines per thread output to log file
+//  TRACE_RING_SIZE       (-DTRACE_RING_SIZE=4096)          : entries kept per thread, power of 2
 // globally define GLOBAL_DEFINE_BOOL to reassign bool (-DGLOBAL_DEFINE_BOOL)
 // #define GLOBAL_BOOL_TYPE int/u8/etc. // optional is char by default
 // #include "global/global.h"
@@ -33,15 +37,138 @@
 #include <stdbool.h>
 #include <math.h>
 #include <assert.h>
+#include <signal.h>
+#include <time.h>
 
 #include "global_types.h"
 #include "global_print.h"
 
+// __rdtsc() for TRACE_TIME()
+#if defined(GLOBAL_DEBUG) && defined(TRACE_PRINT_LOCATION)
+  #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+  #elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+  #endif
+  // open() / write() for the crash dump, see __global_trace_crash_dump()
+  #include <fcntl.h>
+  #if defined(_WIN32)
+    #include <io.h>
+  #else
+    #include <unistd.h>
+  #endif
+  // thread exit callback, frees the threads trace ring for reuse
+  #if defined(_WIN32)
+    #include <windows.h>
+  #else
+    #include <pthread.h>
+  #endif
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 
+// -- trace log format --
+
+// @DOC: what a trace entry was written by
+typedef enum trace_entry_type
+{
+  TRACE_ENTRY_CALL       = 0,   // TRACE()
+  TRACE_ENTRY_ZONE_BEGIN = 1,   // TRACE_ZONE_BEGIN() / TRACE_ZONE(), func is the zones name
+  TRACE_ENTRY_ZONE_END   = 2,   // TRACE_ZONE_END()   / end of TRACE_ZONE() scope
+}trace_entry_type;
+
+// @DOC: layout of binary trace log, TRACE_LOG_BINARY
+//       outside GLOBAL_DEBUG so tools/trace_decode.c can read it
+//       trace_bin_header_t
+//       string_count x { u32 len; char str[len]; }   // func & file names, no '\0'
+//       entry_count  x trace_bin_entry_t              // oldest first
+#define TRACE_BIN_MAGIC    "GTRC"
+#define TRACE_BIN_VERSION  3
+typedef struct
+{
+  char magic[4];        // TRACE_BIN_MAGIC
+  u32  version;         // TRACE_BIN_VERSION
+  u32  entry_count;
+  u32  string_count;
+  // TRACE_TIME() and nanoseconds at TRACE_INIT() and when written, 
+  // to convert trace_bin_entry_t.time to nanoseconds
+  u64  time_start;
+  u64  ns_start;
+  u64  time_end;
+  u64  ns_end;
+}trace_bin_header_t;
+typedef struct
+{
+  u32 func;             // index into string table
+  u32 file;             // index into string table
+  u32 line;
+  u32 thread;
+  u16 type;             // trace_entry_type
+  u16 pad[3];           // 0
+  u64 time;
+}trace_bin_entry_t;
+
+// @DOC: nanoseconds since TRACE_INIT() of a trace_bin_entry_t.time
+INLINE u64 trace_bin_ns(const trace_bin_header_t* header, u64 time)
+{
+  f64 ns_per_tick = header->time_end > header->time_start ? 
+                    (f64)(header->ns_end - header->ns_start) / (f64)(header->time_end - header->time_start) : 1.0;
+  return (u64)((f64)(time - header->time_start) * ns_per_tick);
+}
+
+// @DOC: write trace entries as text, one line per entry
+//       ! func & file of every entry need to be < header->string_count, tools/trace_decode.c checks it
+INLINE void trace_bin_write_text(FILE* f, const trace_bin_header_t* header, const trace_bin_entry_t* entries, const char* const* strings)
+{
+  for (u32 i = 0; i < header->entry_count; ++i)
+  {
+    const trace_bin_entry_t* e = &entries[i];
+    u64 ns = trace_bin_ns(header, e->time);
+    const char* prefix = e->type == TRACE_ENTRY_ZONE_BEGIN ? "zone begin: " : 
+                         e->type == TRACE_ENTRY_ZONE_END   ? "zone end: "   : "";
+    fprintf(f, "[%" PRIu64 ".%06" PRIu64 "ms | thread: %u] %s%s, line: %u, file: %s\n", 
+            ns / 1000000, ns % 1000000, (u32)e->thread, prefix, strings[e->func], e->line, strings[e->file]);
+  }
+}
+
+// @DOC: write json string with quotes and backslashes escaped, windows file paths are full of backslashes
+INLINE void trace_json_write_str(FILE* f, const char* str)
+{
+  fputc('"', f);
+  for (; *str; ++str)
+  {
+    if (*str == '"' || *str == '\\') { fputc('\\', f); }
+    fputc(*str, f);
+  }
+  fputc('"', f);
+}
+
+// @DOC: write trace entries in chrome trace-event json format
+//       open in chrome://tracing or ui.perfetto.dev 
+//       zones become begin/end events, TRACE() calls instant events
+//       ! same as trace_bin_write_text(), string ids need to be < header->string_count
+INLINE void trace_bin_write_chrome(FILE* f, const trace_bin_header_t* header, const trace_bin_entry_t* entries, const char* const* strings)
+{
+  fputs("{\"traceEvents\":[\n", f);
+  for (u32 i = 0; i < header->entry_count; ++i)
+  {
+    const trace_bin_entry_t* e = &entries[i];
+    u64 ns = trace_bin_ns(header, e->time);
+    const char* ph = e->type == TRACE_ENTRY_ZONE_BEGIN ? "B" : 
+                     e->type == TRACE_ENTRY_ZONE_END   ? "E" : "i";
+    fputs("{\"name\":", f); trace_json_write_str(f, strings[e->func]);
+    fprintf(f, ",\"ph\":\"%s\",\"ts\":%" PRIu64 ".%03" PRIu64 ",\"pid\":1,\"tid\":%u", ph, ns / 1000, ns % 1000, (u32)e->thread);
+    if (e->type == TRACE_ENTRY_CALL) { fputs(",\"s\":\"t\"", f); }
+    fputs(",\"args\":{\"file\":", f); trace_json_write_str(f, strings[e->file]);
+    fprintf(f, ",\"line\":%u}}%s\n", e->line, i +1 < header->entry_count ? "," : "");
+  }
+  fputs("],\"displayTimeUnit\":\"ns\"}\n", f);
+}
+
+
 // @DOC: ifdef activates P... macros, ASSERT, ERR..., etc.
 // #define GLOBAL_DEBUG
 #ifdef GLOBAL_DEBUG
@@ -50,105 +177,589 @@ extern "C" {
 
 // @NOTE: need to define 
 //        TRACE_PRINT_LOCATION (-DTRACE_PRINT_LOCATION)
+//        ! globally, optionally also
 //        TRACE_LOG_PATH       (-DTRACE_LOG_PATH=\"trace.log\")
 //        TRACE_LOG_MAX_LINES  (-DTRACE_LOG_MAX_LINES=20) 
-//        ! globally
+//        TRACE_RING_SIZE      (-DTRACE_RING_SIZE=4096) 
 
 #ifdef TRACE_PRINT_LOCATION 
 
-  // @DOC: how many chars max in line of trace log text
-  #define TRACE_LOG_LINE_MAX 256
-  // @DOC: how many lines in trace log text
-  // #define TRACE_LOG_MAX_LINES 25
+  // @DOC: how many entries are kept in the trace ring buffer of each thread
+  //       needs to be power of 2, so the ring index is a mask instead of a division
+  #ifndef TRACE_RING_SIZE
+  #define TRACE_RING_SIZE 4096
+  #endif
+  #if (TRACE_RING_SIZE & (TRACE_RING_SIZE -1)) != 0
+    #error "TRACE_RING_SIZE needs to be a power of 2"
+  #endif
+  // @DOC: how many of the last entries of each thread get written to the log,
+  //       TRACE_EXPORT_CHROME() writes the whole ring
+  #ifndef TRACE_LOG_MAX_LINES
+  #define TRACE_LOG_MAX_LINES 25
+  #endif
+  #if TRACE_LOG_MAX_LINES > TRACE_RING_SIZE
+    #error "TRACE_LOG_MAX_LINES cant be bigger than TRACE_RING_SIZE"
+  #endif
+  // @DOC: file the trace log gets written to, by TRACE_FLUSH(), at exit or on crash
+  #ifndef TRACE_LOG_PATH
+  #define TRACE_LOG_PATH "trace.log"
+  #endif
+  // @DOC: define TRACE_LOG_BINARY (-DTRACE_LOG_BINARY) to write the trace log 
+  //       as binary records instead of text, decode with tools/trace_decode.c
+  // #define TRACE_LOG_BINARY
+
+  // @DOC: timestamp for trace entries, cpu timestamp counter on x86, otherwise nanoseconds
+  //       converted to nanoseconds when the log is written, see trace_bin_header_t
+  #if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #define TRACE_TIME()  ((u64)__rdtsc())
+  #elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define TRACE_TIME()  ((u64)__rdtsc())
+  #else
+    #define TRACE_TIME()  pf_time_ns()
+    #define TRACE_TIME_IS_NS
+  #endif
+  // @DOC: stack size for the crash handler, it runs on its own stack so it also works on stack overflow
+  #ifndef TRACE_SIGNAL_STACK_SIZE
+  #define TRACE_SIGNAL_STACK_SIZE (64 * 1024)
+  #endif
+  // sigaction() & sigaltstack(), hidden in strict -std=c.. modes, then signal() is used
+  #if defined(SA_ONSTACK) && !defined(_WIN32)
+    #define TRACE_SIGNAL_ALTSTACK
+  #endif
   
-  // @DOC: file used for printig trace log to
-  //       fopened in TRACE_INIT()
-  extern FILE* __global_trace_file_pointer__;
-  extern char  __global_trace_file_entries__[TRACE_LOG_MAX_LINES][TRACE_LOG_LINE_MAX];
-  extern char* __global_trace_file_entry_ptrs__[TRACE_LOG_MAX_LINES];
+  // @DOC: one TRACE() call or zone begin/end, only gets formatted when the log is written
+  //       func & file are __func__ & __FILE__ or the zones name, so static strings
+  typedef struct
+  {
+    const char* func;
+    const char* file;
+    u32         line;
+    u32         thread;   // sequential id, 1 for first thread calling TRACE()
+    u16         type;     // trace_entry_type
+    u64         time;     // TRACE_TIME()
+  }trace_entry_t;
+
+  // @DOC: ring buffer of the last TRACE_RING_SIZE TRACE() calls of one thread
+  //       every thread gets its own on its first TRACE(), so no locking needed
+  //       all rings are kept in a list, so TRACE_FLUSH() can merge them
+  //       when a thread exits its ring gets reused by the next new thread,
+  //       so thread churn doesnt leak, the old entries stay until overwritten
+  typedef struct trace_ring_t
+  {
+    struct trace_ring_t* next;          // next in list of all rings
+    u32                  in_use;        // 0 once its thread exited, then it can be claimed
+    u32                  thread;        // id of the thread using it, see trace_entry_t
+    u64                  count;         // total TRACE() calls, next entry is count & (TRACE_RING_SIZE -1)
+    void*                signal_stack;  // TRACE_SIGNAL_STACK_SIZE bytes, kept when the ring gets reused
+    trace_entry_t        entries[TRACE_RING_SIZE];
+  }trace_ring_t;
+
+  // @DOC: ring of the calling thread, NULL until its first TRACE()
+  //       defined in TRACE_REGISTER()
+  extern THREAD_LOCAL trace_ring_t* __global_trace_ring__;
+  // @DOC: list of the rings of all threads, newest first
+  extern trace_ring_t*              __global_trace_rings__;
+  extern u32                        __global_trace_thread_count__;
+  // @DOC: calls __global_trace_ring_release() on thread exit, created in TRACE_INIT()
+  #if defined(_WIN32)
+    // fiber local storage, unlike tls it has a callback on thread exit
+    #define TRACE_RING_KEY_T          DWORD
+    #define TRACE_RING_KEY_CREATE()   ((__global_trace_ring_key__ = FlsAlloc(__global_trace_ring_release)) != FLS_OUT_OF_INDEXES)
+    #define TRACE_RING_KEY_SET(_ring) FlsSetValue(__global_trace_ring_key__, _ring)
+  #else
+    #define TRACE_RING_KEY_T          pthread_key_t
+    #define TRACE_RING_KEY_CREATE()   (pthread_key_create(&__global_trace_ring_key__, __global_trace_ring_release) == 0)
+    #define TRACE_RING_KEY_SET(_ring) pthread_setspecific(__global_trace_ring_key__, _ring)
+  #endif
+  extern TRACE_RING_KEY_T           __global_trace_ring_key__;
+  extern bool                       __global_trace_ring_key_valid__;
+  // @DOC: TRACE_TIME() and pf_time_ns() at TRACE_INIT()
+  extern u64                        __global_trace_time_start__;
+  extern u64                        __global_trace_ns_start__;
   
   // @DOC:  calls init func defined in TRACE_REGISTER()
   #define TRACE_INIT_NAME  __global_trace_init__
   #define TRACE_INIT()     TRACE_INIT_NAME()
+  void TRACE_INIT_NAME(void);
   
-  // @DOC: defines function and extern FILE* used for writing trace log to file
+  // @DOC: defines the trace ring buffer list and init function
   //       need to call TRACE_INIT() as well
   #define TRACE_REGISTER()                                                            \
-    /* define extern FILE*, used for printting trace log to */                        \
-    FILE* __global_trace_file_pointer__ = NULL;                                       \
-    char  __global_trace_file_entries__[TRACE_LOG_MAX_LINES][TRACE_LOG_LINE_MAX];     \
-    char* __global_trace_file_entry_ptrs__[TRACE_LOG_MAX_LINES];                      \
+    THREAD_LOCAL trace_ring_t* __global_trace_ring__          = NULL;                 \
+    trace_ring_t*              __global_trace_rings__         = NULL;                 \
+    u32                        __global_trace_thread_count__  = 0;                    \
+    TRACE_RING_KEY_T           __global_trace_ring_key__;                             \
+    bool                       __global_trace_ring_key_valid__ = false;               \
+    u64                        __global_trace_time_start__    = 0;                    \
+    u64                        __global_trace_ns_start__      = 0;                    \
                                                                                       \
-    void TRACE_INIT_NAME()                                                            \
+    void TRACE_INIT_NAME(void)                                                        \
     {                                                                                 \
-      __global_trace_file_pointer__ = fopen(TRACE_LOG_PATH, "w+");                    \
-      if(__global_trace_file_pointer__ == NULL)                                       \
+      __global_trace_ring_key_valid__ = TRACE_RING_KEY_CREATE();                      \
+      /* truncate, so an old log isnt mistaken for this runs */                       \
+      FILE* f = fopen(TRACE_LOG_PATH, "w");                                           \
+      if(f == NULL)                                                                   \
       { ERR("couldnt open trace log file: %s\n", TRACE_LOG_PATH); }                   \
-      /* rewind(__global_trace_file_pointer__);  / * set to beginnning of file */     \
-      for (int i = 0; i < TRACE_LOG_MAX_LINES; ++i)                                   \
-      { __global_trace_file_entry_ptrs__[i] =  __global_trace_file_entries__[i]; }    \
+      fclose(f);                                                                      \
+      __global_trace_time_start__ = TRACE_TIME();                                     \
+      __global_trace_ns_start__   = pf_time_ns();                                     \
+      atexit(__global_trace_flush);                                                   \
+      TRACE_SIGNAL_SET(SIGSEGV);                                                      \
+      TRACE_SIGNAL_SET(SIGABRT);                                                      \
+      TRACE_SIGNAL_SIGBUS();                                                          \
+      /* main thread gets its ring and signal stack now */                            \
+      if (__global_trace_ring__ == NULL) { __global_trace_ring_register(); }          \
+    }
+  // @DOC: install __global_trace_signal_handler() for _sig, on the alternate signal stack if possible
+  #ifdef TRACE_SIGNAL_ALTSTACK
+    #define TRACE_SIGNAL_SET(_sig)                                                    \
+    {                                                                                 \
+      struct sigaction sa;                                                            \
+      memset(&sa, 0, sizeof(sa));                                                     \
+      sa.sa_handler = __global_trace_signal_handler;                                  \
+      sa.sa_flags   = SA_ONSTACK;                                                     \
+      sigemptyset(&sa.sa_mask);                                                       \
+      sigaction(_sig, &sa, NULL);                                                     \
+    }
+  #else
+    #define TRACE_SIGNAL_SET(_sig) signal(_sig, __global_trace_signal_handler)
+  #endif
+  #ifdef SIGBUS
+    #define TRACE_SIGNAL_SIGBUS() TRACE_SIGNAL_SET(SIGBUS)
+  #else
+    #define TRACE_SIGNAL_SIGBUS()
+  #endif
+
+  // @DOC: called on thread exit with the threads ring, lets the next new thread claim it
+  //       only for threads that called TRACE() after TRACE_INIT(), others keep their ring
+  #if defined(_WIN32)
+  INLINE void WINAPI __global_trace_ring_release(void* ptr)
+  #else
+  INLINE void __global_trace_ring_release(void* ptr)
+  #endif
+  {
+    trace_ring_t* ring = (trace_ring_t*)ptr;
+    if (ring == NULL) { return; }
+  #ifdef TRACE_SIGNAL_ALTSTACK
+    // next thread using the ring reuses the stack
+    stack_t ss;
+    if (sigaltstack(NULL, &ss) == 0 && ss.ss_sp == ring->signal_stack)
+    {
+      ss.ss_flags = SS_DISABLE;
+      sigaltstack(&ss, NULL);
+    }
+  #endif
+    __global_trace_ring__ = NULL;
+    ATOMIC_STORE(&ring->in_use, 0);
+  }
+
+  // @DOC: get a ring for the calling thread, only called once per thread, on its first TRACE()
+  //       claims the ring of an exited thread, or allocates one and adds it to __global_trace_rings__
+  INLINE trace_ring_t* __global_trace_ring_register(void)
+  {
+    trace_ring_t* ring = NULL;
+    for (trace_ring_t* r = (trace_ring_t*)ATOMIC_LOAD(&__global_trace_rings__); r != NULL; r = r->next)
+    {
+      u32 expected = 0;
+      if (ATOMIC_LOAD(&r->in_use) == 0 && ATOMIC_CAS(&r->in_use, &expected, 1)) { ring = r; break; }
+    }
+    if (ring == NULL)
+    {
+      ring = (trace_ring_t*)calloc(1, sizeof(trace_ring_t));
+      ASSERT(ring != NULL);
+      ring->in_use = 1;
+
+      // lock-free push to front of list
+      trace_ring_t* head = (trace_ring_t*)ATOMIC_LOAD(&__global_trace_rings__);
+      do { ring->next = head; }
+      while (!ATOMIC_CAS(&__global_trace_rings__, &head, ring));
     }
+    ring->thread = ATOMIC_FETCH_ADD(&__global_trace_thread_count__, 1) + 1;
+
+  #ifdef TRACE_SIGNAL_ALTSTACK
+    // own stack for the crash handler, unless the thread already has one
+    stack_t ss;
+    if (sigaltstack(NULL, &ss) == 0 && (ss.ss_flags & SS_DISABLE))
+    {
+      if (ring->signal_stack == NULL) { ring->signal_stack = malloc(TRACE_SIGNAL_STACK_SIZE); }
+      if (ring->signal_stack != NULL)
+      {
+        ss.ss_sp    = ring->signal_stack;
+        ss.ss_size  = TRACE_SIGNAL_STACK_SIZE;
+        ss.ss_flags = 0;
+        sigaltstack(&ss, NULL);
+      }
+    }
+  #endif
+
+    __global_trace_ring__ = ring;
+    if (__global_trace_ring_key_valid__) { TRACE_RING_KEY_SET(ring); }
+    return ring;
+  }
 
-  #define TRACE() __global_trace_func(__func__, __FILE__, __LINE__) 
-  INLINE void __global_trace_func(const char* _func, const char* _file, const int _line) 
+  // @DOC: write entry to the calling threads ring
+  INLINE void __global_trace_event(const char* _func, const char* _file, const int _line, trace_entry_type type) 
   {                                                                                     
-    /* move lines around */                                                             
-    __global_trace_file_entry_ptrs__[0] = __global_trace_file_entry_ptrs__[TRACE_LOG_MAX_LINES -1]; 
-    
-    for (int i = TRACE_LOG_MAX_LINES -1; i > 0; --i)                                            
-    { 
-      __global_trace_file_entry_ptrs__[i] = __global_trace_file_entry_ptrs__[i -1]; 
-    }           
-  
-    sprintf(__global_trace_file_entry_ptrs__[0], 
-        "%s, line: %d, file: %s\n",
-        _func, _line, _file);                 
- 
-    // go to start of file, to overwrite
-    // should work i think, but doesnt
-    rewind(__global_trace_file_pointer__);  // set fprintf to beginnning of file 
-    // fseek(__global_trace_file_pointer__, 0, SEEK_SET);
-    // // super slow, but only this works
-    // __global_trace_file_pointer__ = freopen(TRACE_LOG_PATH, "w", __global_trace_file_pointer__);
-    // ASSERT(__global_trace_file_pointer__ != NULL);                                              
-    
-    // P_INT((int)ftell(__global_trace_file_pointer__));
-   
-    if (ftell(__global_trace_file_pointer__) != 0)
+    trace_ring_t* ring = __global_trace_ring__;
+    if (ring == NULL) { ring = __global_trace_ring_register(); }
+
+    trace_entry_t* e = &ring->entries[ring->count & (TRACE_RING_SIZE -1)];
+    e->func   = _func;
+    e->file   = _file;
+    e->line   = (u32)_line;
+    e->thread = ring->thread;
+    e->type   = (u16)type;
+    e->time   = TRACE_TIME();
+    // release, so TRACE_FLUSH() from another thread sees the entry
+    ATOMIC_STORE(&ring->count, ring->count +1);
+  }
+  #define TRACE() __global_trace_event(__func__, __FILE__, __LINE__, TRACE_ENTRY_CALL) 
+
+  // @DOC: time a block of code, shows up as a zone in TRACE_EXPORT_CHROME()
+  //       _name: needs to be a string literal, gets stored as pointer 
+  //       TRACE_ZONE_BEGIN("physics");
+  //       ...
+  //       TRACE_ZONE_END("physics");
+  #define TRACE_ZONE_BEGIN(_name) __global_trace_event(_name, __FILE__, __LINE__, TRACE_ENTRY_ZONE_BEGIN) 
+  #define TRACE_ZONE_END(_name)   __global_trace_event(_name, __FILE__, __LINE__, TRACE_ENTRY_ZONE_END) 
+#ifdef __cplusplus
+  // @DOC: TRACE_ZONE_BEGIN() now, TRACE_ZONE_END() at end of scope
+  //       { TRACE_ZONE("physics"); ... }
+  struct __global_trace_zone_t
+  {
+    const char* name;
+    const char* file;
+    int         line;
+    __global_trace_zone_t(const char* _name, const char* _file, int _line) : name(_name), file(_file), line(_line)
+    { __global_trace_event(name, file, line, TRACE_ENTRY_ZONE_BEGIN); }
+    ~__global_trace_zone_t()
+    { __global_trace_event(name, file, line, TRACE_ENTRY_ZONE_END); }
+  };
+  #define TRACE_ZONE(_name) __global_trace_zone_t PASTE_2(__trace_zone_, __LINE__)(_name, __FILE__, __LINE__)
+#elif defined(__GNUC__) || defined(__clang__)
+  // @DOC: c version of the above, cleanup attribute calls __global_trace_zone_end() when leaving the scope
+  //       not available with msvc, use TRACE_ZONE_BEGIN() / TRACE_ZONE_END() there
+  typedef struct
+  {
+    const char* name;
+    const char* file;
+    int         line;
+  }__global_trace_zone_t;
+  INLINE __global_trace_zone_t __global_trace_zone_begin(const char* _name, const char* _file, int _line)
+  {
+    __global_trace_zone_t zone;
+    zone.name = _name;
+    zone.file = _file;
+    zone.line = _line;
+    __global_trace_event(_name, _file, _line, TRACE_ENTRY_ZONE_BEGIN);
+    return zone;
+  }
+  INLINE void __global_trace_zone_end(__global_trace_zone_t* zone)
+  {
+    __global_trace_event(zone->name, zone->file, zone->line, TRACE_ENTRY_ZONE_END);
+  }
+  #define TRACE_ZONE(_name) __attribute__((cleanup(__global_trace_zone_end))) __global_trace_zone_t PASTE_2(__trace_zone_, __LINE__) = __global_trace_zone_begin(_name, __FILE__, __LINE__)
+#endif // __cplusplus
+
+  // @DOC: index of str in strings, adds it if not in there yet
+  //       strings are compared by pointer, __func__ & __FILE__ are the same pointer for every call
+  //       table: open addressing, size needs to be power of 2 and bigger than max amount of strings
+  INLINE u32 __global_trace_intern(const char** strings, u32* string_count, u32* table, u32 table_size, const char* str)
+  {
+    u32 hash = (u32)(((uintptr_t)str >> 3) * 2654435761u);
+    for (u32 i = 0; i < table_size; ++i)
     {
-      __global_trace_file_pointer__ = freopen(TRACE_LOG_PATH, "w", __global_trace_file_pointer__);
-      ASSERT(__global_trace_file_pointer__ != NULL);                                              
+      u32* slot = &table[(hash + i) & (table_size -1)];
+      if (*slot == 0)                     // 0 is empty, ids are stored +1
+      {
+        strings[*string_count] = str;
+        *slot = ++(*string_count);
+        return *slot -1;
+      }
+      if (strings[*slot -1] == str) { return *slot -1; }
     }
+    return 0;
+  }
 
-    for (int i = TRACE_LOG_MAX_LINES -1; i >= 0; --i)                                           
-    { 
-      // fprintf(__global_trace_file_pointer__, "%s\n", __global_trace_file_entry_ptrs__[i]); 
-      fputs(__global_trace_file_entry_ptrs__[i], __global_trace_file_pointer__); 
-      // fwrite(__global_trace_file_entry_ptrs__[i], sizeof(char), TRACE_LOG_LINE_MAX, __global_trace_file_pointer__); 
-    }            
-    // // fill rest of space
-    
-    // cop out, just putting bit of space between logs and garbage
-    fputs("\n\n\n\n\n", __global_trace_file_pointer__); 
-    
-    // #define SPACE "          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          ""          "
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // fwrite(SPACE, sizeof(char), 200, __global_trace_file_pointer__); 
-    // #undef SPACE
+  // @DOC: sort trace entries oldest first, for qsort()
+  INLINE int __global_trace_entry_cmp(const void* a, const void* b)
+  {
+    u64 ta = ((const trace_entry_t*)a)->time;
+    u64 tb = ((const trace_entry_t*)b)->time;
+    return ta < tb ? -1 : (ta > tb ? 1 : 0);
+  }
+
+  // @DOC: copy the last max_per_ring entries of every threads ring into one array, sorted oldest first
+  //       entries: needs to be free'd, NULL if no memory
+  //       returns amount of entries
+  //       ! entries being written while merging might be torn
+  INLINE u32 __global_trace_merge(trace_entry_t** entries, u32 max_per_ring)
+  {
+    u32 count = 0;
+    for (trace_ring_t* r = (trace_ring_t*)ATOMIC_LOAD(&__global_trace_rings__); r != NULL; r = r->next)
+    { count += max_per_ring; }
+
+    *entries = (trace_entry_t*)malloc(sizeof(trace_entry_t) * count + 1);
+    if (*entries == NULL) { return 0; }
+
+    count = 0;
+    for (trace_ring_t* r = (trace_ring_t*)ATOMIC_LOAD(&__global_trace_rings__); r != NULL; r = r->next)
+    {
+      u64 end   = ATOMIC_LOAD(&r->count);
+      u64 start = end > max_per_ring ? end - max_per_ring : 0;
+      for (u64 i = start; i < end; ++i)
+      { (*entries)[count++] = r->entries[i & (TRACE_RING_SIZE -1)]; }
+    }
+    // each ring is sorted already, but qsort is simpler than a k-way merge and this only runs on dump
+    qsort(*entries, count, sizeof(trace_entry_t), __global_trace_entry_cmp);
+    return count;
+  }
+
+  // @DOC: merge the last max_per_ring entries of all threads rings and turn them into trace log format, see trace_bin_header_t
+  //       strings & entries: need to be free'd, if true is returned
+  INLINE bool __global_trace_to_bin(trace_bin_header_t* header, const char*** strings, trace_bin_entry_t** entries, u32 max_per_ring)
+  {
+    trace_entry_t* merged = NULL;
+    u32 count = __global_trace_merge(&merged, max_per_ring);
+    if (merged == NULL) { return false; }
+
+    memcpy(header->magic, TRACE_BIN_MAGIC, 4);
+    header->version      = TRACE_BIN_VERSION;
+    header->entry_count  = count;
+    header->string_count = 0;
+    header->time_start   = __global_trace_time_start__;
+    header->ns_start     = __global_trace_ns_start__;
+    header->time_end     = TRACE_TIME();
+    header->ns_end       = pf_time_ns();
+
+    // every entry has 2 strings at most, table is power of 2 at least twice that
+    u32 table_size = 1;
+    while (table_size < count * 4) { table_size *= 2; }
+    u32* table = (u32*)calloc(table_size, sizeof(u32));
+    *strings   = (const char**)malloc(sizeof(const char*) * count * 2 + 1);
+    *entries   = (trace_bin_entry_t*)malloc(sizeof(trace_bin_entry_t) * count + 1);
+    if (table == NULL || *strings == NULL || *entries == NULL)
+    { free(table); free((void*)*strings); free(*entries); free(merged); return false; }
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      trace_entry_t*     e = &merged[i];
+      trace_bin_entry_t* b = &(*entries)[i];
+      b->func   = __global_trace_intern(*strings, &header->string_count, table, table_size, e->func);
+      b->file   = __global_trace_intern(*strings, &header->string_count, table, table_size, e->file);
+      b->line   = e->line;
+      b->thread = e->thread;
+      b->type   = e->type;
+      b->pad[0] = 0; b->pad[1] = 0; b->pad[2] = 0;
+      b->time   = e->time;
+    }
+    free(table);
+    free(merged);
+    return true;
+  }
+
+  // @DOC: write the last TRACE_LOG_MAX_LINES TRACE() calls of every thread to TRACE_LOG_PATH,
+  //       merged by time, oldest first
+  //       as text, or as binary if TRACE_LOG_BINARY is defined
+  //       also called at exit, after TRACE_INIT()
+  //       on crash __global_trace_crash_dump() is used instead
+  #define TRACE_FLUSH() __global_trace_flush()
+  INLINE void __global_trace_flush(void)
+  {
+    trace_bin_header_t header;
+    const char**       strings = NULL;
+    trace_bin_entry_t* entries = NULL;
+    if (!__global_trace_to_bin(&header, &strings, &entries, TRACE_LOG_MAX_LINES)) 
+    { P_ERR("couldnt allocate memory for writing trace log\n"); return; }
+
+#ifdef TRACE_LOG_BINARY
+    FILE* f = fopen(TRACE_LOG_PATH, "wb");
+#else
+    FILE* f = fopen(TRACE_LOG_PATH, "w");
+#endif
+    if (f == NULL) 
+    { P_ERR("couldnt open trace log file: %s\n", TRACE_LOG_PATH); free((void*)strings); free(entries); return; }
 
+#ifdef TRACE_LOG_BINARY
+    fwrite(&header, sizeof(header), 1, f);
+    for (u32 i = 0; i < header.string_count; ++i)
+    {
+      u32 len = (u32)strlen(strings[i]);
+      fwrite(&len, sizeof(len), 1, f);
+      fwrite(strings[i], 1, len, f);
+    }
+    fwrite(entries, sizeof(trace_bin_entry_t), header.entry_count, f);
+#else
+    trace_bin_write_text(f, &header, entries, strings);
+#endif // TRACE_LOG_BINARY
+
+    fclose(f);
+    free((void*)strings); 
+    free(entries);
+  }
+
+  // @DOC: write all TRACE_RING_SIZE entries of every thread in chrome trace-event json format
+  //       open in chrome://tracing or ui.perfetto.dev to see TRACE_ZONE()'s as flame chart
+  //       binary logs can be converted using: trace_decode trace.log --chrome
+  #define TRACE_EXPORT_CHROME(_path) __global_trace_export_chrome(_path)
+  INLINE void __global_trace_export_chrome(const char* path)
+  {
+    trace_bin_header_t header;
+    const char**       strings = NULL;
+    trace_bin_entry_t* entries = NULL;
+    if (!__global_trace_to_bin(&header, &strings, &entries, TRACE_RING_SIZE)) 
+    { P_ERR("couldnt allocate memory for exporting trace\n"); return; }
+
+    FILE* f = fopen(path, "w");
+    if (f == NULL) 
+    { P_ERR("couldnt open file for exporting trace: %s\n", path); free((void*)strings); free(entries); return; }
+
+    trace_bin_write_chrome(f, &header, entries, strings);
+    fclose(f);
+    free((void*)strings); 
+    free(entries);
+  }
+  
+  // -- crash dump --
+  // everything below only uses async-signal-safe calls, no stdio, no malloc, no locks
+  // so the crash handler works even when crashing inside malloc() or printf()
+  
+  #if defined(_WIN32)
+    #define TRACE_CRASH_OPEN(_path)           _open(_path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE)
+    #define TRACE_CRASH_WRITE(_fd, _buf, _len) _write(_fd, _buf, (unsigned int)(_len))
+    #define TRACE_CRASH_CLOSE(_fd)            _close(_fd)
+  #else
+    #define TRACE_CRASH_OPEN(_path)           open(_path, O_WRONLY | O_CREAT | O_TRUNC, 0644)
+    #define TRACE_CRASH_WRITE(_fd, _buf, _len) write(_fd, _buf, _len)
+    #define TRACE_CRASH_CLOSE(_fd)            close(_fd)
+  #endif
+  
+  // @DOC: append str to buf, cut off at cap, returns new pos
+  INLINE u32 __global_trace_crash_str(char* buf, u32 pos, u32 cap, const char* str)
+  {
+    while (*str && pos < cap) { buf[pos++] = *str++; }
+    return pos;
+  }
+  // @DOC: append v as decimal to buf, padded with 0 to min_digits, cut off at cap, returns new pos
+  INLINE u32 __global_trace_crash_u64(char* buf, u32 pos, u32 cap, u64 v, u32 min_digits)
+  {
+    char digits[20];
+    u32  len = 0;
+    do { digits[len++] = (char)('0' + v % 10); v /= 10; } while (v > 0);
+    while (len < min_digits && len < 20) { digits[len++] = '0'; }
+    while (len > 0 && pos < cap) { buf[pos++] = digits[--len]; }
+    return pos;
+  }
+  
+  // @DOC: write the last TRACE_LOG_MAX_LINES entries of every thread to TRACE_LOG_PATH, oldest first
+  //       same text as TRACE_FLUSH(), also with TRACE_LOG_BINARY, so it can be read without tools
+  //       rings are merged by picking the next oldest entry over and over, 
+  //       O(n^2) but needs no memory and only runs once
+  //       ! rings of threads still running might get overwritten while dumping
+  INLINE void __global_trace_crash_dump(int sig)
+  {
+    int fd = TRACE_CRASH_OPEN(TRACE_LOG_PATH);
+    if (fd < 0) { return; }
+
+    trace_bin_header_t header;
+    header.time_start = __global_trace_time_start__;
+    header.ns_start   = __global_trace_ns_start__;
+  #if defined(PF_TIME_SIGNAL_SAFE)
+    header.time_end   = TRACE_TIME();
+    header.ns_end     = pf_time_ns();
+  #else
+    // no async signal safe clock, skip the end time, trace_bin_ns() then keeps TRACE_TIME() units
+    header.time_end   = header.time_start;
+    header.ns_end     = header.ns_start;
+  #endif
+
+    char buf[512];
+    u32  pos = 0;
+    pos = __global_trace_crash_str(buf, pos, sizeof(buf), "crashed with signal: ");
+    pos = __global_trace_crash_u64(buf, pos, sizeof(buf), (u64)sig, 0);
+    pos = __global_trace_crash_str(buf, pos, sizeof(buf), "\n");
+  #if !defined(PF_TIME_SIGNAL_SAFE) && !defined(TRACE_TIME_IS_NS)
+    pos = __global_trace_crash_str(buf, pos, sizeof(buf), "no signal safe clock, times below are TRACE_TIME() ticks / 1000000, not ms\n");
+  #endif
+    if (TRACE_CRASH_WRITE(fd, buf, pos) < 0) { TRACE_CRASH_CLOSE(fd); return; }
+
+    // key of last written entry: time, thread, index in ring
+    bool first       = true;
+    u64  last_time   = 0;
+    u32  last_thread = 0;
+    u64  last_idx    = 0;
+    for (;;)
+    {
+      const trace_entry_t* next = NULL;
+      u64 next_idx = 0;
+      for (trace_ring_t* r = (trace_ring_t*)ATOMIC_LOAD(&__global_trace_rings__); r != NULL; r = r->next)
+      {
+        u64 end   = ATOMIC_LOAD(&r->count);
+        u64 start = end > TRACE_LOG_MAX_LINES ? end - TRACE_LOG_MAX_LINES : 0;
+        for (u64 i = start; i < end; ++i)
+        {
+          const trace_entry_t* e = &r->entries[i & (TRACE_RING_SIZE -1)];
+          bool after_last = first || e->time > last_time || 
+                            (e->time == last_time && (e->thread > last_thread || 
+                            (e->thread == last_thread && i > last_idx)));
+          bool before_next = next == NULL || e->time < next->time || 
+                             (e->time == next->time && (e->thread < next->thread ||
+                             (e->thread == next->thread && i < next_idx)));
+          if (after_last && before_next) { next = e; next_idx = i; }
+        }
+      }
+      if (next == NULL) { break; }
+      first       = false;
+      last_time   = next->time;
+      last_thread = next->thread;
+      last_idx    = next_idx;
+
+      // [ms.us_ns | thread: n] prefix func, line: n, file: path
+      u64 ns = trace_bin_ns(&header, next->time);
+      pos = 0;
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, "[");
+      pos = __global_trace_crash_u64(buf, pos, sizeof(buf) -1, ns / 1000000, 0);
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, ".");
+      pos = __global_trace_crash_u64(buf, pos, sizeof(buf) -1, ns % 1000000, 6);
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, "ms | thread: ");
+      pos = __global_trace_crash_u64(buf, pos, sizeof(buf) -1, next->thread, 0);
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, "] ");
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, 
+                                     next->type == TRACE_ENTRY_ZONE_BEGIN ? "zone begin: " : 
+                                     next->type == TRACE_ENTRY_ZONE_END   ? "zone end: "   : "");
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, next->func);
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, ", line: ");
+      pos = __global_trace_crash_u64(buf, pos, sizeof(buf) -1, next->line, 0);
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, ", file: ");
+      pos = __global_trace_crash_str(buf, pos, sizeof(buf) -1, next->file);
+      buf[pos++] = '\n';
+      if (TRACE_CRASH_WRITE(fd, buf, pos) < 0) { break; }
+    }
+    TRACE_CRASH_CLOSE(fd);
+  }
+
+  // @DOC: writes the trace log when crashing, then crashes as it would have
+  //       installed for SIGSEGV, SIGABRT and SIGBUS by TRACE_INIT()
+  //       ERR(), ASSERT(), etc. abort(), so they end up here as well
+  //       with TRACE_SIGNAL_ALTSTACK it runs on the threads own signal stack, so stack overflows get dumped too
+  INLINE void __global_trace_signal_handler(int sig)
+  {
+    __global_trace_crash_dump(sig);
+    signal(sig, SIG_DFL);
+    raise(sig);
   }
 
 #else   // TRACE_PRINT_LOCATION
   #define TRACE_INIT()   
   #define TRACE_REGISTER()
   #define TRACE()
+  #define TRACE_FLUSH()
+  #define TRACE_ZONE_BEGIN(_name)
+  #define TRACE_ZONE_END(_name)
+  #if defined(__cplusplus) || defined(__GNUC__) || defined(__clang__)
+  #define TRACE_ZONE(_name)
+  #endif
+  #define TRACE_EXPORT_CHROME(_path)
 #endif  // TRACE_PRINT_LOCATION
 
 // -- func wrapper --
@@ -211,6 +822,13 @@ extern "C" {
 #define TRACE_INIT()   
 #define TRACE_REGISTER()
 #define TRACE()
+#define TRACE_FLUSH()
+#define TRACE_ZONE_BEGIN(_name)
+#define TRACE_ZONE_END(_name)
+#if defined(__cplusplus) || defined(__GNUC__) || defined(__clang__)
+#define TRACE_ZONE(_name)
+#endif
+#define TRACE_EXPORT_CHROME(_path)
 
 #endif // GLOBAL_DEBUG
 
@@ -223,5 +841,8 @@ extern "C" {
 #include "io_util.h"    // needs IO_UTIL_IMPLEMENTATION    defined ONCE
 #include "str_util.h"   // needs STR_UTIL_IMPLEMENTATION   defined ONCE
 #include "bump_alloc.h" // needs BUMP_ALLOC_IMPLEMENTATION defined ONCE
+#include "pool_alloc.h"
+#include "str_builder.h"
+#include "str_intern.h"
 
 #endif // GLOBAL_GLOBAL_H
@@ -14,6 +14,9 @@
 // for printing macros, define globally:
 //  GLOBAL_DEBUG          (-DGLOBAL_DEBUG)                  : compile in/out P/PF/P_ macros
 //  PF_PRINT_LOCATION     (-DPF_PRINT_LOCATION)             : make P/PF/P_ macros print location
+//  PF_ASYNC              (-DPF_ASYNC)                      : P/PF/P_ macros print from a background thread
+//  PF_LOG_LEVELS         (-DPF_LOG_LEVELS)                 : runtime log levels per module, env var PF_LEVEL
+//  PF_STRUCTURED         (-DPF_STRUCTURED)                 : P_V/P_ macros can print json/binary, env var PF_OUTPUT
 // for tracing, define globally:
 //  TRACE_PRINT_LOCATION  (-DTRACE_PRINT_LOCATION)          : compile in TRACE macros
 //  TRACE_LOG_PATH        (-DTRACE_LOG_PATH=\"trace.log\")  : path/name of trace log file
@@ -29,32 +32,1108 @@
 // libs needed basically everywhere
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "global_types.h"
 
+#ifdef PF_ASYNC
+  #include <stdarg.h>
+  #include <stdlib.h>
+  #include <string.h>
+  #if defined(_WIN32)
+    #include <windows.h>
+    #include <io.h>
+  #else
+    #include <pthread.h>
+    #include <sched.h>
+    #include <unistd.h>
+  #endif
+#endif
+
+#ifdef PF_LOG_LEVELS
+  #include <stdlib.h>
+  #include <string.h>
+#endif
+
+#ifdef PF_STRUCTURED
+  #include <stdlib.h>
+  #include <string.h>
+  #if defined(_WIN32)
+    #include <io.h>
+    #include <fcntl.h>
+  #endif
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// -- time --
+
+// @DOC: monotonic nanoseconds, only meaningful as difference between two calls
+//       posix clock_gettime() is async signal safe, then PF_TIME_SIGNAL_SAFE gets defined
+//       strict -std=c.. modes hide CLOCK_MONOTONIC, there c11 timespec_get() is used,
+//       and in c99 time(), which only has seconds resolution
+#if defined(CLOCK_MONOTONIC) && !defined(_WIN32)
+  #define PF_TIME_SIGNAL_SAFE
+  INLINE u64 pf_time_ns(void)
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+  }
+#elif defined(TIME_UTC)
+  INLINE u64 pf_time_ns(void)
+  {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+  }
+#else
+  INLINE u64 pf_time_ns(void)
+  {
+    return (u64)time(NULL) * 1000000000ull;
+  }
+#endif
+
+// @DOC: wall clock nanoseconds since 1970, for timestamps and pthread timed waits
+//       same fallbacks as pf_time_ns(), PF_TIME_REAL_PRECISE gets defined if its better than seconds
+#if defined(CLOCK_REALTIME) && !defined(_WIN32)
+  #define PF_TIME_REAL_PRECISE
+  INLINE u64 pf_time_real_ns(void)
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+  }
+#elif defined(TIME_UTC)
+  #define PF_TIME_REAL_PRECISE
+  INLINE u64 pf_time_real_ns(void)
+  {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+  }
+#else
+  INLINE u64 pf_time_real_ns(void)
+  {
+    return (u64)time(NULL) * 1000000000ull;
+  }
+#endif
+
+// -- output --
+
+// @DOC: define PF_ASYNC (-DPF_ASYNC) to move printing off the calling thread
+//       every P_/PF/ERR macro gets formatted into one record per thread,
+//       PF_END() pushes it into a lock-free queue,
+//       a background thread writes the queued records to stdout in batches with one write()
+//       need PF_ASYNC_REGISTER() once in a .c file and PF_ASYNC_INIT() at start of main
+//       before PF_ASYNC_INIT() and after exit records get written directly
+//       ! order with plain printf() calls isnt kept
+// #define PF_ASYNC
+//       _PF_WRITE() writes len bytes of buf as they are, also '\0'
+#ifdef PF_ASYNC
+  #define _PF_OUT(...)          __pf_async_append(__VA_ARGS__)
+  #define _PF_WRITE(_buf, _len) __pf_async_append_raw(_buf, _len)
+  #define PF_END()              __pf_async_commit()
+  #define PF_ABORT()            { __pf_async_flush(); abort(); }
+#else
+  #define _PF_OUT(...)          printf(__VA_ARGS__)
+  #define _PF_WRITE(_buf, _len) fwrite(_buf, 1, _len, stdout)
+  #define PF_END()      
+  #define PF_ABORT()            abort()
+#endif
+
+#ifdef PF_ASYNC
+
+  // @DOC: max bytes of one record, longer output gets split into multiple records
+  #ifndef PF_ASYNC_RECORD_SIZE
+  #define PF_ASYNC_RECORD_SIZE  512
+  #endif
+  // @DOC: records the queue holds, needs to be power of 2
+  //       when full, calling threads wait for the background thread
+  #ifndef PF_ASYNC_QUEUE_SIZE
+  #define PF_ASYNC_QUEUE_SIZE   1024
+  #endif
+  // @DOC: max bytes written by one write() of the background thread
+  #ifndef PF_ASYNC_BATCH_SIZE
+  #define PF_ASYNC_BATCH_SIZE   (64 * 1024)
+  #endif
+
+  // @DOC: one slot in the queue, seq says who can use it next 
+  //       seq == pos: free for producer at pos, seq == pos +1: filled, ready for background thread
+  typedef struct
+  {
+    u64  seq;
+    u32  len;
+    char data[PF_ASYNC_RECORD_SIZE];
+  }pf_async_slot_t;
+
+  // @DOC: record the calling thread is currently formatting into, one per thread
+  typedef struct
+  {
+    u32  len;
+    char data[PF_ASYNC_RECORD_SIZE];
+  }pf_async_record_t;
+
+  #if defined(_WIN32)
+    typedef HANDLE    pf_async_thread_t;
+  #else
+    typedef pthread_t pf_async_thread_t;
+  #endif
+
+  // @DOC: defined in PF_ASYNC_REGISTER()
+  extern pf_async_slot_t                __pf_async_slots__[PF_ASYNC_QUEUE_SIZE];
+  extern u64                            __pf_async_enqueue_pos__;   // next slot to fill
+  extern u64                            __pf_async_dequeue_pos__;   // next slot to write
+  extern u64                            __pf_async_written_pos__;   // all slots before this are written
+  extern u32                            __pf_async_running__;       // background thread started
+  extern u32                            __pf_async_stop__;          // background thread should exit
+  extern pf_async_thread_t              __pf_async_thread__;
+  extern THREAD_LOCAL pf_async_record_t __pf_async_record__;
+
+  // @DOC: defines the queue, need to call PF_ASYNC_INIT() as well
+  #define PF_ASYNC_REGISTER()                                                   \
+    pf_async_slot_t                __pf_async_slots__[PF_ASYNC_QUEUE_SIZE];     \
+    u64                            __pf_async_enqueue_pos__  = 0;               \
+    u64                            __pf_async_dequeue_pos__  = 0;               \
+    u64                            __pf_async_written_pos__  = 0;               \
+    u32                            __pf_async_running__      = 0;               \
+    u32                            __pf_async_stop__         = 0;               \
+    pf_async_thread_t              __pf_async_thread__;                         \
+    THREAD_LOCAL pf_async_record_t __pf_async_record__       = { 0 };
+
+  INLINE void __pf_async_write(const char* buf, u32 len)
+  {
+  #if defined(_WIN32)
+    _write(1, buf, len);
+  #else
+    while (len > 0)
+    {
+      ssize_t n = write(1, buf, len);
+      if (n <= 0) { return; }
+      buf += n; len -= (u32)n;
+    }
+  #endif
+  }
+  
+  INLINE void __pf_async_yield(void)
+  {
+  #if defined(_WIN32)
+    SwitchToThread();
+  #else
+    sched_yield();
+  #endif
+  }
+
+  // @DOC: push the calling threads record into the queue, does nothing if its empty
+  //       the P_/PF/ERR macros call this via PF_END()
+  INLINE void __pf_async_commit(void)
+  {
+    pf_async_record_t* r = &__pf_async_record__;
+    if (r->len == 0) { return; }
+    if (!ATOMIC_LOAD(&__pf_async_running__)) 
+    { 
+      fflush(stdout);
+      __pf_async_write(r->data, r->len); 
+      r->len = 0; 
+      return; 
+    }
+
+    u64 pos = ATOMIC_LOAD(&__pf_async_enqueue_pos__);
+    for (;;)
+    {
+      pf_async_slot_t* slot = &__pf_async_slots__[pos & (PF_ASYNC_QUEUE_SIZE -1)];
+      u64 seq = ATOMIC_LOAD(&slot->seq);
+      if (seq == pos)
+      {
+        // claim slot, on fail pos gets set to the current enqueue pos
+        if (ATOMIC_CAS(&__pf_async_enqueue_pos__, &pos, pos +1))
+        {
+          memcpy(slot->data, r->data, r->len);
+          slot->len = r->len;
+          ATOMIC_STORE(&slot->seq, pos +1);
+          break;
+        }
+      }
+      else if (seq < pos) 
+      {
+        // full, wait for background thread
+        __pf_async_yield(); 
+        pos = ATOMIC_LOAD(&__pf_async_enqueue_pos__); 
+      }
+      else { pos = ATOMIC_LOAD(&__pf_async_enqueue_pos__); }
+    }
+    r->len = 0;
+  }
+
+  // @DOC: append bytes to the calling threads record, split into multiple records if needed
+  INLINE void __pf_async_append_raw(const char* buf, u32 n)
+  {
+    pf_async_record_t* r = &__pf_async_record__;
+    for (u32 i = 0; i < n; )
+    {
+      if (r->len == PF_ASYNC_RECORD_SIZE) { __pf_async_commit(); }
+      u32 len = n - i;
+      if (len > PF_ASYNC_RECORD_SIZE - r->len) { len = PF_ASYNC_RECORD_SIZE - r->len; }
+      memcpy(r->data + r->len, buf + i, len);
+      r->len += len;
+      i      += len;
+    }
+  }
+
+  // @DOC: printf into the calling threads record
+  //       output not fitting into the record gets split
+  //       not INLINE, functions with ... cant be forced inline
+#if defined(__GNUC__) || defined(__clang__)
+  __attribute__((format(printf, 1, 2)))
+#endif
+  static inline void __pf_async_append(const char* fmt, ...)
+  {
+    pf_async_record_t* r = &__pf_async_record__;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(r->data + r->len, PF_ASYNC_RECORD_SIZE - r->len, fmt, args);
+    va_end(args);
+    if (n < 0) { return; }
+    if (r->len + (u32)n < PF_ASYNC_RECORD_SIZE) { r->len += (u32)n; return; }
+
+    // didnt fit, format into temp buffer and push in record sized pieces
+    char* buf = (char*)malloc((size_t)n +1);
+    if (buf == NULL) { return; }
+    va_start(args, fmt);
+    vsnprintf(buf, (size_t)n +1, fmt, args);
+    va_end(args);
+    __pf_async_append_raw(buf, (u32)n);
+    free(buf);
+  }
+
+  // @DOC: write all queued records, in as few write() calls as possible
+  //       only called by the background thread, or after it exited
+  //       returns true if anything was written
+  INLINE bool __pf_async_drain(void)
+  {
+    static THREAD_LOCAL char batch[PF_ASYNC_BATCH_SIZE];
+    u32 len = 0;
+    u64 pos = __pf_async_dequeue_pos__;
+    for (;;)
+    {
+      pf_async_slot_t* slot = &__pf_async_slots__[pos & (PF_ASYNC_QUEUE_SIZE -1)];
+      if (ATOMIC_LOAD(&slot->seq) != pos +1) { break; }
+      if (len + slot->len > PF_ASYNC_BATCH_SIZE)
+      {
+        __pf_async_write(batch, len);
+        ATOMIC_STORE(&__pf_async_written_pos__, pos);
+        len = 0;
+      }
+      memcpy(batch + len, slot->data, slot->len);
+      len += slot->len;
+      // hand slot back to producers, one lap later
+      ATOMIC_STORE(&slot->seq, pos + PF_ASYNC_QUEUE_SIZE);
+      pos++;
+      ATOMIC_STORE(&__pf_async_dequeue_pos__, pos);
+    }
+    if (len > 0) 
+    { 
+      __pf_async_write(batch, len);
+      ATOMIC_STORE(&__pf_async_written_pos__, pos);
+    }
+    return len > 0;
+  }
+
+  // @DOC: background thread, drains the queue and sleeps ~1ms when its empty
+#if defined(_WIN32)
+  INLINE DWORD WINAPI __pf_async_thread_func(LPVOID arg)
+#else
+  INLINE void* __pf_async_thread_func(void* arg)
+#endif
+  {
+    (void)arg;
+  #if !defined(_WIN32)
+    // timed wait on a private condition as sleep, nanosleep() isnt in c11
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t  cond  = PTHREAD_COND_INITIALIZER;
+    pthread_mutex_lock(&mutex);
+  #endif
+    while (!ATOMIC_LOAD(&__pf_async_stop__))
+    {
+      if (__pf_async_drain()) { continue; }
+    #if defined(_WIN32)
+      Sleep(1);
+    #elif defined(PF_TIME_REAL_PRECISE)
+      u64 t = pf_time_real_ns() + 1000000;
+      struct timespec ts;
+      ts.tv_sec  = (time_t)(t / 1000000000ull);
+      ts.tv_nsec = (long)(t % 1000000000ull);
+      pthread_cond_timedwait(&cond, &mutex, &ts);
+    #else
+      // only time() in strict c99, a deadline from it can be up to 1s in the past
+      (void)cond;
+      __pf_async_yield();
+    #endif
+    }
+    __pf_async_drain();
+  #if !defined(_WIN32)
+    pthread_mutex_unlock(&mutex);
+  #endif
+    return 0;
+  }
+
+  // @DOC: push the calling threads record and wait till everything queued is written
+  //       called before abort() by ERR(), ASSERT(), etc.
+  #define PF_ASYNC_FLUSH() __pf_async_flush()
+  INLINE void __pf_async_flush(void)
+  {
+    __pf_async_commit();
+    if (!ATOMIC_LOAD(&__pf_async_running__)) { return; }
+    u64 end = ATOMIC_LOAD(&__pf_async_enqueue_pos__);
+    while (ATOMIC_LOAD(&__pf_async_written_pos__) < end) { __pf_async_yield(); }
+  }
+
+  // @DOC: stop background thread after writing everything queued, called at exit
+  INLINE void __pf_async_shutdown(void)
+  {
+    __pf_async_commit();
+    if (!ATOMIC_LOAD(&__pf_async_running__)) { return; }
+    ATOMIC_STORE(&__pf_async_stop__, 1);
+  #if defined(_WIN32)
+    WaitForSingleObject(__pf_async_thread__, INFINITE);
+    CloseHandle(__pf_async_thread__);
+  #else
+    pthread_join(__pf_async_thread__, NULL);
+  #endif
+    ATOMIC_STORE(&__pf_async_running__, 0);
+    // records pushed while the thread was exiting
+    __pf_async_drain();
+  }
+
+  // @DOC: start background thread, everything printed before is written directly
+  #define PF_ASYNC_INIT() __pf_async_init()
+  INLINE void __pf_async_init(void)
+  {
+    if (ATOMIC_LOAD(&__pf_async_running__)) { return; }
+    for (u64 i = 0; i < PF_ASYNC_QUEUE_SIZE; ++i) 
+    { __pf_async_slots__[i].seq = i; }
+    __pf_async_enqueue_pos__ = 0;
+    __pf_async_dequeue_pos__ = 0;
+    __pf_async_written_pos__ = 0;
+    __pf_async_stop__        = 0;
+    fflush(stdout);
+  #if defined(_WIN32)
+    __pf_async_thread__ = CreateThread(NULL, 0, __pf_async_thread_func, NULL, 0, NULL);
+    if (__pf_async_thread__ == NULL) { return; }
+  #else
+    if (pthread_create(&__pf_async_thread__, NULL, __pf_async_thread_func, NULL) != 0) { return; }
+  #endif
+    ATOMIC_STORE(&__pf_async_running__, 1);
+    atexit(__pf_async_shutdown);
+  }
+
+#else   // PF_ASYNC
+  #define PF_ASYNC_REGISTER()
+  #define PF_ASYNC_INIT()
+  #define PF_ASYNC_FLUSH()
+#endif  // PF_ASYNC
+
+// -- log levels --
+
+// @DOC: define PF_LOG_LEVELS (-DPF_LOG_LEVELS) to filter the print macros at runtime
+//       P/PF/P_INT/P_V/etc. are PF_LEVEL_DEBUG, P_INFO PF_LEVEL_INFO, P_WARN PF_LEVEL_WARN,
+//       P_ERR/P_ERR_CHECK PF_LEVEL_ERROR, ERR/ERR_CHECK/ASSERT always print, as they abort
+//       level can be set for all files and per module, a module is any part of the files path
+//       or PF_MODULE, if defined before including global.h
+//       set via env var PF_LEVEL, read by PF_LEVEL_INIT(), or pf_level_set() / pf_level_set_module()
+//        PF_LEVEL=warn                     -> only warnings and errors
+//        PF_LEVEL=warn,render=trace        -> same, but everything in files with "render" in their path
+//        PF_LEVEL=debug,audio.c=off        -> nothing from audio.c
+//       need PF_LEVEL_REGISTER() once in a .c file
+//       every call site caches if its enabled, so a disabled macro is two loads and a compare,
+//       its arguments dont get evaluated
+// #define PF_LOG_LEVELS
+typedef enum pf_level
+{
+  PF_LEVEL_TRACE = 0,
+  PF_LEVEL_DEBUG,
+  PF_LEVEL_INFO,
+  PF_LEVEL_WARN,
+  PF_LEVEL_ERROR,
+  PF_LEVEL_OFF,
+}pf_level;
+
+#ifdef PF_LOG_LEVELS
+
+  #ifndef PF_MODULE
+  #define PF_MODULE __FILE__
+  #endif
+  // @DOC: max amount of per module levels
+  #ifndef PF_LEVEL_MAX_MODULES
+  #define PF_LEVEL_MAX_MODULES 32
+  #endif
+  
+  typedef struct
+  {
+    char     name[64];    // matches every module containing it
+    pf_level level;
+  }pf_level_module_t;
+
+  // @DOC: defined in PF_LEVEL_REGISTER()
+  extern pf_level          __pf_level__;          // level for modules without own level
+  extern u32               __pf_level_min__;      // lowest level enabled anywhere, for early out
+  extern u32               __pf_level_gen__;      // incremented on every change, invalidates call site caches
+  extern pf_level_module_t __pf_level_modules__[PF_LEVEL_MAX_MODULES];
+  extern u32               __pf_level_module_count__;
+
+  // @DOC: defines the levels, optionally call PF_LEVEL_INIT() to read env var PF_LEVEL
+  #define PF_LEVEL_REGISTER()                                                 \
+    pf_level          __pf_level__              = PF_LEVEL_TRACE;             \
+    u32               __pf_level_min__          = PF_LEVEL_TRACE;             \
+    u32               __pf_level_gen__          = 1;                          \
+    pf_level_module_t __pf_level_modules__[PF_LEVEL_MAX_MODULES];             \
+    u32               __pf_level_module_count__ = 0;
+
+  // @DOC: level for module, last matching module level wins
+  INLINE pf_level __pf_level_of(const char* module)
+  {
+    pf_level level = __pf_level__;
+    for (u32 i = 0; i < __pf_level_module_count__; ++i)
+    {
+      if (strstr(module, __pf_level_modules__[i].name) != NULL) 
+      { level = __pf_level_modules__[i].level; }
+    }
+    return level;
+  }
+
+  // @DOC: check if _level is enabled at call site, site caches the level of module
+  //       site: (gen << 8) | level, 0 until first use
+  INLINE bool __pf_level_on(u32 _level, u64* site, const char* module)
+  {
+    if (_level < ATOMIC_LOAD(&__pf_level_min__)) { return false; }
+    u64 gen    = ATOMIC_LOAD(&__pf_level_gen__);
+    u64 cached = ATOMIC_LOAD(site);
+    if ((cached >> 8) != gen)
+    {
+      cached = (gen << 8) | (u64)__pf_level_of(module);
+      ATOMIC_STORE(site, cached);
+    }
+    return _level >= (u32)(cached & 0xFF);
+  }
+
+  // @DOC: recalculate __pf_level_min__ and invalidate call site caches
+  INLINE void __pf_level_changed(void)
+  {
+    u32 min = __pf_level__;
+    for (u32 i = 0; i < __pf_level_module_count__; ++i)
+    { if ((u32)__pf_level_modules__[i].level < min) { min = __pf_level_modules__[i].level; } }
+    ATOMIC_STORE(&__pf_level_min__, min);
+    ATOMIC_FETCH_ADD(&__pf_level_gen__, 1);
+  }
+
+  // @DOC: set level for all modules without own level
+  INLINE void pf_level_set(pf_level level)
+  {
+    __pf_level__ = level;
+    __pf_level_changed();
+  }
+
+  // @DOC: set level for all files with module in their path, or PF_MODULE
+  //       returns false if there are already PF_LEVEL_MAX_MODULES modules
+  INLINE bool pf_level_set_module(const char* module, pf_level level)
+  {
+    u32 i = 0;
+    while (i < __pf_level_module_count__ && strcmp(__pf_level_modules__[i].name, module) != 0) { i++; }
+    if (i >= PF_LEVEL_MAX_MODULES) { return false; }
+    
+    strncpy(__pf_level_modules__[i].name, module, sizeof(__pf_level_modules__[i].name) -1);
+    __pf_level_modules__[i].name[sizeof(__pf_level_modules__[i].name) -1] = '\0';
+    __pf_level_modules__[i].level = level;
+    if (i == __pf_level_module_count__) { __pf_level_module_count__++; }
+    __pf_level_changed();
+    return true;
+  }
+
+  // @DOC: level from its name, "trace", "debug", "info", "warn", "error", "off"
+  //       len: length of str
+  //       returns false if str isnt a level
+  INLINE bool pf_level_from_str(const char* str, u32 len, pf_level* level)
+  {
+    const char* names[] = { "trace", "debug", "info", "warn", "error", "off" };
+    for (u32 i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+    {
+      if (strlen(names[i]) == len && strncmp(names[i], str, len) == 0)
+      { *level = (pf_level)i; return true; }
+    }
+    return false;
+  }
+
+  // @DOC: apply levels in format of env var PF_LEVEL, e.g. "warn,render=trace,audio.c=off"
+  //       returns false if part of spec couldnt be parsed, the rest still gets applied
+  INLINE bool pf_level_parse(const char* spec)
+  {
+    bool ok = true;
+    while (*spec)
+    {
+      const char* end = spec;
+      const char* eq  = NULL;
+      while (*end && *end != ',') { if (*end == '=') { eq = end; } end++; }
+
+      pf_level level;
+      if (eq == NULL)
+      {
+        if (pf_level_from_str(spec, (u32)(end - spec), &level)) { pf_level_set(level); }
+        else { ok = false; }
+      }
+      else 
+      {
+        char module[64];
+        u32  len = (u32)(eq - spec);
+        if (len > 0 && len < sizeof(module) && pf_level_from_str(eq +1, (u32)(end - eq -1), &level))
+        {
+          memcpy(module, spec, len);
+          module[len] = '\0';
+          ok = pf_level_set_module(module, level) && ok;
+        }
+        else { ok = false; }
+      }
+      spec = *end ? end +1 : end;
+    }
+    return ok;
+  }
+
+  // @DOC: read levels from env var PF_LEVEL, see pf_level_parse()
+  #define PF_LEVEL_INIT()                                                     \
+    {                                                                         \
+      const char* __pf_level_env = getenv("PF_LEVEL");                        \
+      if (__pf_level_env != NULL && !pf_level_parse(__pf_level_env))          \
+      { P_ERR("couldnt parse env var PF_LEVEL: %s\n", __pf_level_env); }      \
+    }
+  
+  // @DOC: execute ... only if _level is enabled for this file
+  //       PF_IF_LEVEL(PF_LEVEL_TRACE, P_V(x); P_V(y);)
+  #define PF_IF_LEVEL(_level, ...)                                                  \
+    { static u64 __pf_site__ = 0; if (__pf_level_on(_level, &__pf_site__, PF_MODULE)) { __VA_ARGS__ } }
+
+#else   // PF_LOG_LEVELS
+  #define PF_LEVEL_REGISTER()
+  #define PF_LEVEL_INIT()
+  #define PF_IF_LEVEL(_level, ...)  { __VA_ARGS__ }
+#endif  // PF_LOG_LEVELS
+
+// -- number to text --
+
+// @DOC: integer, float, hex and binary to text, used by the P_ macros instead of printf conversions
+//       all write into buf without '\0' and return the amount of chars written
+//       buf needs room for PF_FMT_MAX chars, except pf_fmt_bin(): bits chars
+//       pf_fmt_f64()/pf_fmt_f32() write the shortest text that reads back as the same value, grisu2
+//       e.g. 0.1f -> "0.1", 100.0 -> "100.0", 1e30 -> "1e30", nan -> "nan"
+#define PF_FMT_MAX 32
+
+// @DOC: two digit lookup tables, "00" "01" ... "99" & "00" "01" ... "ff"
+#define __PF_DEC_ROW(d) #d "0" #d "1" #d "2" #d "3" #d "4" #d "5" #d "6" #d "7" #d "8" #d "9"
+#define __PF_HEX_ROW(h) #h "0" #h "1" #h "2" #h "3" #h "4" #h "5" #h "6" #h "7" #h "8" #h "9" #h "a" #h "b" #h "c" #h "d" #h "e" #h "f"
+static const char __pf_dec_pairs__[] =
+  __PF_DEC_ROW(0) __PF_DEC_ROW(1) __PF_DEC_ROW(2) __PF_DEC_ROW(3) __PF_DEC_ROW(4)
+  __PF_DEC_ROW(5) __PF_DEC_ROW(6) __PF_DEC_ROW(7) __PF_DEC_ROW(8) __PF_DEC_ROW(9);
+static const char __pf_hex_pairs__[] =
+  __PF_HEX_ROW(0) __PF_HEX_ROW(1) __PF_HEX_ROW(2) __PF_HEX_ROW(3) __PF_HEX_ROW(4) __PF_HEX_ROW(5) __PF_HEX_ROW(6) __PF_HEX_ROW(7)
+  __PF_HEX_ROW(8) __PF_HEX_ROW(9) __PF_HEX_ROW(a) __PF_HEX_ROW(b) __PF_HEX_ROW(c) __PF_HEX_ROW(d) __PF_HEX_ROW(e) __PF_HEX_ROW(f);
+#undef __PF_DEC_ROW
+#undef __PF_HEX_ROW
+
+static const u64 __pf_pow10__[20] =
+{
+  1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+  10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+  1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+};
+
+// @DOC: count leading zero bits, v != 0
+INLINE u32 __pf_clz64(u64 v)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long i; _BitScanReverse64(&i, v); return 63 - (u32)i;
+#else
+  return (u32)__builtin_clzll(v);
+#endif
+}
+
+// @DOC: amount of decimal digits in v, log10 from the bit length, no loop
+INLINE u32 __pf_dec_digits(u64 v)
+{
+  v |= 1;   // 0 has 1 digit, doesnt change the count of other numbers
+  u32 t = ((64 - __pf_clz64(v)) * 1233) >> 12;
+  return t + 1 - (v < __pf_pow10__[t] ? 1 : 0);
+}
+
+INLINE u32 pf_fmt_u64(char* buf, u64 v)
+{
+  u32 len = __pf_dec_digits(v);
+  char* p = buf + len;
+  while (v >= 100)
+  {
+    u32 i = (u32)(v % 100) * 2;
+    v /= 100;
+    p -= 2; memcpy(p, __pf_dec_pairs__ + i, 2);
+  }
+  if (v >= 10) { p -= 2; memcpy(p, __pf_dec_pairs__ + v * 2, 2); }
+  else         { *--p = (char)('0' + v); }
+  return len;
+}
+
+INLINE u32 pf_fmt_s64(char* buf, s64 v)
+{
+  if (v >= 0) { return pf_fmt_u64(buf, (u64)v); }
+  buf[0] = '-';
+  return pf_fmt_u64(buf +1, 0ull - (u64)v) +1;   // 0 - u64 so INT64_MIN doesnt overflow
+}
+
+// @DOC: lowercase hex without 0x, at least min_digits, padded with 0
+INLINE u32 pf_fmt_hex(char* buf, u64 v, u32 min_digits)
+{
+  u32 len = v == 0 ? 1 : (64 - __pf_clz64(v) + 3) / 4;
+  if (len < min_digits) { len = min_digits > 16 ? 16 : min_digits; }
+  char* p = buf + len;
+  for (u32 i = 0; i + 2 <= len; i += 2) { p -= 2; memcpy(p, __pf_hex_pairs__ + (v & 0xFF) * 2, 2); v >>= 8; }
+  if (len & 1) { *--p = __pf_hex_pairs__[(v & 0xF) * 2 +1]; }
+  return len;
+}
+
+// @DOC: pointer as 0x and hex, same on every platform unlike %p
+INLINE u32 pf_fmt_ptr(char* buf, const void* v)
+{
+  buf[0] = '0'; buf[1] = 'x';
+  return pf_fmt_hex(buf +2, (u64)(uintptr_t)v, 1) +2;
+}
+
+// @DOC: spread the 8 bits of b into 8 chars '0'/'1', msb first
+//       multiply copies b into every byte, the mask keeps bit 7 - i in byte i
+//       adding 0x7F moves any set bit into the bytes high bit, no carry bc. bytes are <= 0x80
+INLINE void __pf_fmt_byte_bin(char* buf, u8 b)
+{
+  u64 x = ((u64)b * 0x0101010101010101ull) & 0x0102040810204080ull;
+  x = (((x + 0x7F7F7F7F7F7F7F7Full) >> 7) & 0x0101010101010101ull) + 0x3030303030303030ull;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  x = __builtin_bswap64(x);
+#endif
+  memcpy(buf, &x, 8);
+}
+
+// @DOC: lowest bits of v as binary, msb first, bits is 1 - 64
+INLINE u32 pf_fmt_bin(char* buf, u64 v, u32 bits)
+{
+  char* p = buf;
+  u32 rest = bits & 7;
+  for (u32 i = 0; i < rest; ++i) { *p++ = (char)('0' + ((v >> (bits -1 - i)) & 1)); }
+  for (s32 shift = (s32)(bits - rest) - 8; shift >= 0; shift -= 8, p += 8)
+  { __pf_fmt_byte_bin(p, (u8)(v >> shift)); }
+  return bits;
+}
+
+// @DOC: grisu2 by florian loitsch, boundaries & digit generation after milo yips dtoa
+//       f * 2^e with 64 bit f, cached powers are 10^-348 ... 10^340 in steps of 8
+typedef struct { u64 f; s32 e; }__pf_diy_fp_t;
+
+INLINE __pf_diy_fp_t __pf_diy_normalize(__pf_diy_fp_t v)
+{
+  u32 s = __pf_clz64(v.f);
+  v.f <<= s; v.e -= (s32)s;
+  return v;
+}
+
+INLINE __pf_diy_fp_t __pf_diy_mul(__pf_diy_fp_t x, __pf_diy_fp_t y)
+{
+  const u64 m32 = 0xFFFFFFFFull;
+  u64 a = x.f >> 32, b = x.f & m32, c = y.f >> 32, d = y.f & m32;
+  u64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  u64 tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1ull << 31);   // round
+  __pf_diy_fp_t r = { ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64 };
+  return r;
+}
+
+// @DOC: cached power c with c.e + e in [-60, -32], k is its decimal exponent
+INLINE __pf_diy_fp_t __pf_cached_pow10(s32 e, s32* k)
+{
+  static const u64 pow_f[87] =
+  {
+    0xfa8fd5a0081c0288ull, 0xbaaee17fa23ebf76ull, 0x8b16fb203055ac76ull, 0xcf42894a5dce35eaull,
+    0x9a6bb0aa55653b2dull, 0xe61acf033d1a45dfull, 0xab70fe17c79ac6caull, 0xff77b1fcbebcdc4full,
+    0xbe5691ef416bd60cull, 0x8dd01fad907ffc3cull, 0xd3515c2831559a83ull, 0x9d71ac8fada6c9b5ull,
+    0xea9c227723ee8bcbull, 0xaecc49914078536dull, 0x823c12795db6ce57ull, 0xc21094364dfb5637ull,
+    0x9096ea6f3848984full, 0xd77485cb25823ac7ull, 0xa086cfcd97bf97f4ull, 0xef340a98172aace5ull,
+    0xb23867fb2a35b28eull, 0x84c8d4dfd2c63f3bull, 0xc5dd44271ad3cdbaull, 0x936b9fcebb25c996ull,
+    0xdbac6c247d62a584ull, 0xa3ab66580d5fdaf6ull, 0xf3e2f893dec3f126ull, 0xb5b5ada8aaff80b8ull,
+    0x87625f056c7c4a8bull, 0xc9bcff6034c13053ull, 0x964e858c91ba2655ull, 0xdff9772470297ebdull,
+    0xa6dfbd9fb8e5b88full, 0xf8a95fcf88747d94ull, 0xb94470938fa89bcfull, 0x8a08f0f8bf0f156bull,
+    0xcdb02555653131b6ull, 0x993fe2c6d07b7facull, 0xe45c10c42a2b3b06ull, 0xaa242499697392d3ull,
+    0xfd87b5f28300ca0eull, 0xbce5086492111aebull, 0x8cbccc096f5088ccull, 0xd1b71758e219652cull,
+    0x9c40000000000000ull, 0xe8d4a51000000000ull, 0xad78ebc5ac620000ull, 0x813f3978f8940984ull,
+    0xc097ce7bc90715b3ull, 0x8f7e32ce7bea5c70ull, 0xd5d238a4abe98068ull, 0x9f4f2726179a2245ull,
+    0xed63a231d4c4fb27ull, 0xb0de65388cc8ada8ull, 0x83c7088e1aab65dbull, 0xc45d1df942711d9aull,
+    0x924d692ca61be758ull, 0xda01ee641a708deaull, 0xa26da3999aef774aull, 0xf209787bb47d6b85ull,
+    0xb454e4a179dd1877ull, 0x865b86925b9bc5c2ull, 0xc83553c5c8965d3dull, 0x952ab45cfa97a0b3ull,
+    0xde469fbd99a05fe3ull, 0xa59bc234db398c25ull, 0xf6c69a72a3989f5cull, 0xb7dcbf5354e9beceull,
+    0x88fcf317f22241e2ull, 0xcc20ce9bd35c78a5ull, 0x98165af37b2153dfull, 0xe2a0b5dc971f303aull,
+    0xa8d9d1535ce3b396ull, 0xfb9b7cd9a4a7443cull, 0xbb764c4ca7a44410ull, 0x8bab8eefb6409c1aull,
+    0xd01fef10a657842cull, 0x9b10a4e5e9913129ull, 0xe7109bfba19c0c9dull, 0xac2820d9623bf429ull,
+    0x80444b5e7aa7cf85ull, 0xbf21e44003acdd2dull, 0x8e679c2f5e44ff8full, 0xd433179d9c8cb841ull,
+    0x9e19db92b4e31ba9ull, 0xeb96bf6ebadf77d9ull, 0xaf87023b9bf0ee6bull,
+  };
+  static const s16 pow_e[87] =
+  {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+  };
+  f64 dk  = (-61 - e) * 0.30102999566398114 + 347;   // dk must be positive, so can do ceiling in positive
+  s32 ik  = (s32)dk;
+  if (dk - ik > 0.0) { ik++; }
+  u32 i   = (u32)((ik >> 3) + 1);
+  *k      = -(-348 + (s32)(i * 8));
+  __pf_diy_fp_t r = { pow_f[i], pow_e[i] };
+  return r;
+}
+
+INLINE void __pf_grisu_round(char* buf, u32 len, u64 delta, u64 rest, u64 ten_kappa, u64 wp_w)
+{
+  while (rest < wp_w && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+  {
+    buf[len -1]--;
+    rest += ten_kappa;
+  }
+}
+
+// @DOC: shortest digits of f * 2^e into buf, value is digits * 10^k
+//       lower_closer: f is a power of 2, so the next smaller value is half as far away
+INLINE u32 __pf_grisu2(char* buf, u64 f, s32 e, bool lower_closer, s32* k)
+{
+  __pf_diy_fp_t v  = { f, e };
+  __pf_diy_fp_t pl = { (f << 1) + 1, e -1 };
+  __pf_diy_fp_t mi = { (f << 1) -1, e -1 };
+  if (lower_closer) { mi.f = (f << 2) -1; mi.e = e -2; }
+  pl    = __pf_diy_normalize(pl);
+  mi.f <<= mi.e - pl.e;
+  mi.e  = pl.e;
+  
+  s32 mk;
+  __pf_diy_fp_t c  = __pf_cached_pow10(pl.e, &mk);
+  __pf_diy_fp_t w  = __pf_diy_mul(__pf_diy_normalize(v), c);
+  __pf_diy_fp_t wp = __pf_diy_mul(pl, c);
+  __pf_diy_fp_t wm = __pf_diy_mul(mi, c);
+  wm.f++; wp.f--;
+  u64 delta = wp.f - wm.f;
+  *k = mk;
+
+  // digit generation
+  u32 shift = (u32)-wp.e;
+  u64 one   = 1ull << shift;
+  u64 wp_w  = wp.f - w.f;
+  u32 p1    = (u32)(wp.f >> shift);
+  u64 p2    = wp.f & (one -1);
+  s32 kappa = (s32)__pf_dec_digits(p1);
+  u32 len   = 0;
+  while (kappa > 0)
+  {
+    u32 div = (u32)__pf_pow10__[kappa -1];
+    u32 d   = p1 / div;
+    p1     %= div;
+    if (d || len) { buf[len++] = (char)('0' + d); }
+    kappa--;
+    u64 tmp = ((u64)p1 << shift) + p2;
+    if (tmp <= delta)
+    {
+      *k += kappa;
+      __pf_grisu_round(buf, len, delta, tmp, __pf_pow10__[kappa] << shift, wp_w);
+      return len;
+    }
+  }
+  for (;;)
+  {
+    p2    *= 10;
+    delta *= 10;
+    u32 d  = (u32)(p2 >> shift);
+    if (d || len) { buf[len++] = (char)('0' + d); }
+    p2    &= one -1;
+    kappa--;
+    if (p2 < delta)
+    {
+      *k += kappa;
+      __pf_grisu_round(buf, len, delta, p2, one, wp_w * (-kappa < 20 ? __pf_pow10__[-kappa] : 0));
+      return len;
+    }
+  }
+}
+
+// @DOC: place decimal point or exponent for digits * 10^k
+INLINE u32 __pf_fmt_digits(char* buf, const char* digits, u32 len, s32 k)
+{
+  s32 point = (s32)len + k;   // position of decimal point in digits
+  char* p = buf;
+  if (k >= 0 && point <= 21)          // 1234e7 -> 12340000000.0
+  {
+    memcpy(p, digits, len); p += len;
+    for (s32 i = 0; i < k; ++i) { *p++ = '0'; }
+    *p++ = '.'; *p++ = '0';
+  }
+  else if (point > 0 && point <= 21)  // 1234e-2 -> 12.34
+  {
+    memcpy(p, digits, (u32)point); p += point;
+    *p++ = '.';
+    memcpy(p, digits + point, len - (u32)point); p += len - (u32)point;
+  }
+  else if (point > -6 && point <= 0)  // 1234e-6 -> 0.001234
+  {
+    *p++ = '0'; *p++ = '.';
+    for (s32 i = 0; i < -point; ++i) { *p++ = '0'; }
+    memcpy(p, digits, len); p += len;
+  }
+  else                                // 1234e30 -> 1.234e33
+  {
+    *p++ = digits[0];
+    if (len > 1) { *p++ = '.'; for (u32 i = 1; i < len; ++i) { *p++ = digits[i]; } }
+    *p++ = 'e';
+    p += pf_fmt_s64(p, point -1);
+  }
+  return (u32)(p - buf);
+}
+
+// @DOC: float from sign, exponent & mantissa bits
+//       mant_bits: 52 for f64, 23 for f32, bias: 1023 / 127
+INLINE u32 __pf_fmt_float(char* buf, bool neg, u64 mant, u32 exp, u32 mant_bits, u32 exp_max, s32 bias)
+{
+  char* p = buf;
+  if (exp == exp_max)
+  {
+    if (mant != 0) { memcpy(p, "nan", 3); return 3; }
+    if (neg) { *p++ = '-'; }
+    memcpy(p, "inf", 3);
+    return (u32)(p - buf) + 3;
+  }
+  if (neg) { *p++ = '-'; }
+  if (exp == 0 && mant == 0) { memcpy(p, "0.0", 3); return (u32)(p - buf) + 3; }
+
+  u64  f            = exp == 0 ? mant : mant | (1ull << mant_bits);
+  s32  e            = (exp == 0 ? 1 : (s32)exp) - bias - (s32)mant_bits;
+  bool lower_closer = mant == 0 && exp > 1;
+  char digits[24];
+  s32  k;
+  u32  len = __pf_grisu2(digits, f, e, lower_closer, &k);
+  if (len > 17) { len = 17; }   // never more than 17 digits, but gcc cant tell and warns about digits overflowing
+  return (u32)(p - buf) + __pf_fmt_digits(p, digits, len, k);
+}
+
+INLINE u32 pf_fmt_f64(char* buf, f64 v)
+{
+  u64 bits; memcpy(&bits, &v, sizeof(bits));
+  return __pf_fmt_float(buf, bits >> 63, bits & ((1ull << 52) -1), (u32)(bits >> 52) & 0x7FF, 52, 0x7FF, 1023);
+}
+
+// @DOC: shortest text for the f32, 0.1f -> "0.1" instead of "0.10000000149011612"
+INLINE u32 pf_fmt_f32(char* buf, f32 v)
+{
+  u32 bits; memcpy(&bits, &v, sizeof(bits));
+  return __pf_fmt_float(buf, bits >> 31, bits & ((1u << 23) -1), (bits >> 23) & 0xFF, 23, 0xFF, 127);
+}
+
+// @DOC: same as the pf_fmt_ functions, but '\0' terminated, for passing to printf's %s
+//       char num[PF_FMT_MAX]; _PF("%s\n", PF_FMT_STR(num, pf_fmt_u64, v));
+#define PF_FMT_STR(_buf, _func, ...)  ((_buf)[_func(_buf, __VA_ARGS__)] = '\0', (_buf))
+
+// @DOC: hex or binary dump of len bytes at data, one line per per_line bytes, with offset column
+//       00000000: 48656c6c 6f2c2077 6f726c64 210a0000  |Hello, world!...|
+//       00000000: 01001000.01100101 01101100.01101100
+//       group: bytes without space between them, per_line: bytes per line, 0 for defaults
+//       hex lines end in the bytes as ascii, '.' for non printable
+//       pf_dump_size() is the max amount of chars pf_dump_fmt() writes
+typedef enum pf_dump_base
+{
+  PF_DUMP_HEX,
+  PF_DUMP_BIN,
+}pf_dump_base;
+
+INLINE void __pf_dump_defaults(pf_dump_base base, u32* group, u32* per_line)
+{
+  if (*per_line == 0) { *per_line = base == PF_DUMP_HEX ? 16 : 4; }
+  if (*group    == 0) { *group    = base == PF_DUMP_HEX ? 4  : 2; }
+  if (*group > *per_line) { *group = *per_line; }
+}
+
+INLINE u64 pf_dump_size(u64 len, pf_dump_base base, u32 group, u32 per_line)
+{
+  __pf_dump_defaults(base, &group, &per_line);
+  u64 lines = (len + per_line -1) / per_line;
+  u64 line  = 16 + 2                                                // offset & ": "
+            + (u64)per_line * (base == PF_DUMP_HEX ? 2 : 9)         // bytes & '.'
+            + (per_line + group -1) / group                         // spaces
+            + (base == PF_DUMP_HEX ? 4 + per_line : 0)              // "  |" ascii "|"
+            + 1;                                                    // '\n'
+  return lines * line;
+}
+
+INLINE u64 pf_dump_fmt(char* buf, const void* data, u64 len, pf_dump_base base, u32 group, u32 per_line)
+{
+  __pf_dump_defaults(base, &group, &per_line);
+  const u8* bytes  = (const u8*)data;
+  u32 offset_width = len > 0xFFFFFFFFull ? 16 : 8;
+  char* p = buf;
+  for (u64 line = 0; line < len; line += per_line)
+  {
+    u32 n = len - line < per_line ? (u32)(len - line) : per_line;
+    p += pf_fmt_hex(p, line, offset_width);
+    *p++ = ':'; 
+    for (u32 i = 0; i < per_line; ++i)
+    {
+      if (i >= n && base == PF_DUMP_BIN) { break; }
+      if (i % group == 0)             { *p++ = ' '; }
+      else if (base == PF_DUMP_BIN)   { *p++ = '.'; }
+      if (i >= n) { *p++ = ' '; *p++ = ' '; continue; }   // pad so ascii column lines up
+      if (base == PF_DUMP_HEX) { memcpy(p, __pf_hex_pairs__ + bytes[line + i] * 2, 2); p += 2; }
+      else                     { __pf_fmt_byte_bin(p, bytes[line + i]); p += 8; }
+    }
+    if (base == PF_DUMP_HEX)
+    {
+      *p++ = ' '; *p++ = ' '; *p++ = '|';
+      for (u32 i = 0; i < n; ++i) 
+      { u8 c = bytes[line + i]; *p++ = c >= 0x20 && c < 0x7F ? (char)c : '.'; }
+      *p++ = '|';
+    }
+    *p++ = '\n';
+  }
+  return (u64)(p - buf);
+}
+
+// -- escape codes --
+
+// @DOC: terminal escape codes as string literals, so they can be pasted into format strings
+//       and every macro prints with a single printf, instead of formatting PF_STYLE() at runtime
+//       PF_ESC(style, color) takes the numbers of pf_mode and pf_color, enums cant be stringified
+//       empty without GLOBAL_DEBUG, same as PF_COLOR(), etc.
+#ifdef GLOBAL_DEBUG
+  #define PF_ESC(_style, _color)  "\033[" #_style ";" #_color "m"
+#else
+  #define PF_ESC(_style, _color)  ""
+#endif
+#define PF_ESC_RED        PF_ESC(0, 31)                   // PF_COLOR(PF_RED)
+#define PF_ESC_GREEN      PF_ESC(0, 32)                   // PF_COLOR(PF_GREEN)
+#define PF_ESC_YELLOW     PF_ESC(0, 33)                   // PF_COLOR(PF_YELLOW)
+#define PF_ESC_PURPLE     PF_ESC(0, 35)                   // PF_COLOR(PF_PURPLE)
+#define PF_ESC_CYAN       PF_ESC(0, 36)                   // PF_COLOR(PF_CYAN)
+#define PF_ESC_WHITE      PF_ESC(0, 37)                   // PF_COLOR(PF_WHITE)
+#define PF_ESC_RESET      PF_ESC(0, 37)                   // PF_STYLE_RESET()
+#define PF_ESC_LOCATION   PF_ESC(2, 37) PF_ESC(3, 37)     // dim & italic, used by P_LOCATION()
+
 // always have these macros
 
+// @DOC: format of location, args are file, func, line
+#define __P_LOC_FMT  " -> file: %s\n -> func: %s, line: %d\n"
 // @DOC: print location, as in file and line, append anywhere that info is usefull
-#define ___P_LOCATION(_file, _func, _line) printf(" -> file: %s\n -> func: %s, line: %d\n", _file, _func, _line); 
+#define ___P_LOCATION(_file, _func, _line) _PF_OUT(__P_LOC_FMT, _file, _func, _line); PF_END(); 
 #define __P_LOCATION() ___P_LOCATION(__FILE__, __func__, __LINE__)
 
+// -- error rate limit --
+
+// @DOC: P_ERR/P_ERR_CHECK print at most PF_ERR_BURST errors at once and PF_ERR_RATE per second, per call site
+//       the first error over the limit prints "[ERROR] suppressing further repeats of this error",
+//       the rest gets counted and reported with the next error of that call site, as
+//       "[ERROR] suppressed 1234 repeats of this error", or at exit if there is none
+//       define PF_ERR_RATE 0 to print every error
+#ifndef PF_ERR_RATE
+#define PF_ERR_RATE   10
+#endif
+#ifndef PF_ERR_BURST
+#define PF_ERR_BURST  10
+#endif
+
+#if PF_ERR_RATE > 0
+  // @DOC: state of one call site, generic cell rate algorithm, so no timer needed
+  //       ! not atomic, with multiple threads failing at the same site a few more or less get printed
+  typedef struct pf_rate_t
+  {
+    u64               tat;          // theoretical arrival time of next error, nanoseconds
+    u32               suppressed;   // errors not printed since last printed one
+    u32               listed;       // 1 once in __pf_rate_sites__
+    const char*       file;
+    const char*       func;
+    int               line;
+    struct pf_rate_t* next;         // next site in __pf_rate_sites__
+  }pf_rate_t;
+
+  // @DOC: call sites that suppressed errors, per translation unit, reported at exit
+  static pf_rate_t* __pf_rate_sites__ = NULL;
+
+  // @DOC: print suppressed counts nobody printed yet, registered with atexit() by __pf_rate_allow()
+  INLINE void __pf_rate_report(void)
+  {
+    for (pf_rate_t* site = (pf_rate_t*)ATOMIC_LOAD(&__pf_rate_sites__); site != NULL; site = site->next)
+    {
+      if (site->suppressed == 0) { continue; }
+      _PF_OUT(PF_ESC_RED "[ERROR] " PF_ESC_RESET "suppressed %u repeats of this error\n", site->suppressed);
+      ___P_LOCATION(site->file, site->func, site->line);
+      site->suppressed = 0;
+    }
+  }
+
+  // @DOC: true if error at site should be printed, prints the suppressed count first
+  INLINE bool __pf_rate_allow(pf_rate_t* site)
+  {
+    const u64 interval = 1000000000ull / PF_ERR_RATE;
+    u64 now = pf_time_ns();
+
+    if (site->tat < now) { site->tat = now; }
+    if (site->tat - now > (PF_ERR_BURST -1) * interval) 
+    { 
+      if (site->suppressed++ > 0) { return false; }
+      _PF_OUT(PF_ESC_RED "[ERROR] " PF_ESC_RESET "suppressing further repeats of this error, max. %d per second\n", PF_ERR_RATE);
+      ___P_LOCATION(site->file, site->func, site->line);
+      // add to list once, first site in list registers the report
+      u32 listed = 0;
+      if (ATOMIC_CAS(&site->listed, &listed, 1))
+      {
+        pf_rate_t* head = (pf_rate_t*)ATOMIC_LOAD(&__pf_rate_sites__);
+        do { site->next = head; } while (!ATOMIC_CAS(&__pf_rate_sites__, &head, site));
+        if (head == NULL) { atexit(__pf_rate_report); }
+      }
+      return false; 
+    }
+    site->tat += interval;
+    if (site->suppressed > 0)
+    {
+      _PF_OUT(PF_ESC_RED "[ERROR] " PF_ESC_RESET "suppressed %u repeats of this error\n", site->suppressed);
+      site->suppressed = 0;
+    }
+    return true;
+  }
+  // @DOC: execute ... only if the call site isnt over its rate limit
+  #define PF_IF_RATE(...) { static pf_rate_t __pf_rate__ = { 0, 0, 0, __FILE__, __func__, __LINE__, NULL }; if (__pf_rate_allow(&__pf_rate__)) { __VA_ARGS__ } }
+#else
+  #define PF_IF_RATE(...) { __VA_ARGS__ }
+#endif // PF_ERR_RATE > 0
+
 // @DOC: print an error with location, without stopping the execution, doesnt print location
-#define _P_ERR(...)	PF_COLOR(PF_RED); printf("[ERROR] "); PF_STYLE_RESET(); printf(__VA_ARGS__)
+//       ! format needs to be a string literal, its pasted after the prefix
+#define _P_ERR(...)	_PF_OUT(PF_ESC_RED "[ERROR] " PF_ESC_RESET __VA_ARGS__)
+// @DOC: _P_ERR() for formats that arent string literals, prints prefix and message separately
+#define _P_ERR_V(...)	{ _PF_OUT(PF_ESC_RED "[ERROR] " PF_ESC_RESET); _PF_OUT(__VA_ARGS__); }
 // @DOC: print an error with location, without stopping the execution
-#define P_ERR(...)	_P_ERR(__VA_ARGS__); __P_LOCATION()
+//       rate limited, see PF_ERR_RATE
+#define P_ERR(...)	PF_IF_LEVEL(PF_LEVEL_ERROR, PF_IF_RATE(_P_ERR(__VA_ARGS__); __P_LOCATION()))
+#define P_ERR_V(...)	PF_IF_LEVEL(PF_LEVEL_ERROR, PF_IF_RATE(_P_ERR_V(__VA_ARGS__); __P_LOCATION()))
 // @DOC: print an error with location if the condition c if false, stopping the execution
-#define ASSERT(c)   if(!(c)) { PF_COLOR(PF_RED); printf("[ASSERT]" ); PF_STYLE_RESET(); printf("'%s'\n", #c); __P_LOCATION(); abort(); }
+#define ASSERT(c)   if(!(c)) { _PF_OUT(PF_ESC_RED "[ASSERT]" PF_ESC_RESET "'%s'\n" __P_LOC_FMT, #c, __FILE__, __func__, __LINE__); PF_END(); PF_ABORT(); }
 // @DOC: print an error with location, stopping the execution
-#define ERR(...)  P_ERR(__VA_ARGS__); abort();
+#define ERR(...)  _P_ERR(__VA_ARGS__); __P_LOCATION(); PF_ABORT();
+#define ERR_V(...)  _P_ERR_V(__VA_ARGS__); __P_LOCATION(); PF_ABORT();
 // @DOC: print an error with location, and custom message if the condition c if false, stopping the execution
-#define ERR_CHECK(c, ...) if(!(c)) { _P_ERR("\033[1;37m[[ %s ]]\033[0;37m\n", #c); printf("        "); printf(__VA_ARGS__); __P_LOCATION(); abort(); }
+#define ERR_CHECK(c, ...) if(!(c)) { _P_ERR(PF_ESC(1, 37) "[[ %s ]]" PF_ESC(0, 37) "\n        ", #c); _PF_OUT(__VA_ARGS__); __P_LOCATION(); PF_ABORT(); }
 // @DOC: print an error with location, and custom message if the condition c if false, without stopping the execution
 #define P_ERR_CHECK(c, ...) if(!(c)) { P_ERR(__VA_ARGS__); }
 
-#define _P_ASSERT_FIX(...)	PF_COLOR(PF_RED); printf("[ASSERT_FIX] "); PF_STYLE_RESET(); printf(__VA_ARGS__)
+#define _P_ASSERT_FIX(...)	_PF_OUT(PF_ESC_RED "[ASSERT_FIX] " PF_ESC_RESET __VA_ARGS__)
 // @DOC: print an error with location, and custom message if the condition c if false, 
 //       if ASSERT_FIX_USE_FIX is defined abort() otherwise then execute code block in ... aka. __VA_ARGS__
 //       example:
@@ -66,9 +1145,9 @@ extern "C" {
 //        arr[i] = 123;
 #ifdef ASSERT_FIX_USE_FIX
   #define ASSERT_FIX(c, ...)                                                                                     \
-    if(!(c)) { _P_ASSERT_FIX("\033[1;37m[[ %s ]]\033[0;37m\n", #c); __P_LOCATION(); __VA_ARGS__ }
+    if(!(c)) { PF_IF_LEVEL(PF_LEVEL_ERROR, PF_IF_RATE(_P_ASSERT_FIX(PF_ESC(1, 37) "[[ %s ]]" PF_ESC(0, 37) "\n", #c); __P_LOCATION())) __VA_ARGS__ }
 #else
-  #define ASSERT_FIX(c, ...) if(!(c)) { _P_ASSERT_FIX("\033[1;37m[[ %s ]]\033[0;37m\n", #c); __P_LOCATION(); abort(); }
+  #define ASSERT_FIX(c, ...) if(!(c)) { _P_ASSERT_FIX(PF_ESC(1, 37) "[[ %s ]]" PF_ESC(0, 37) "\n", #c); __P_LOCATION(); PF_ABORT(); }
 #endif
 
 // -- static assert --
@@ -91,6 +1170,12 @@ extern "C" {
 #define EXPAND_TO_STR(v)  TO_STR(v)
 // @DOC: turn bool to string
 #define STR_BOOL(v) ((v) ? "true" : "false")
+// @DOC: long / unsigned long entries for _Generic(), empty where they are s64 / u64 already
+#ifdef GLOBAL_S64_IS_LONG
+  #define __GENERIC_LONG(...)
+#else
+  #define __GENERIC_LONG(...) __VA_ARGS__
+#endif
 #define STR_TYPE(v) _Generic((v),                \
         bool:           "bool",                  \
         u8:             "u8",                    \
@@ -103,8 +1188,7 @@ extern "C" {
         s64:            "s64",                   \
         f32:            "f32",                   \
         f64:            "f64",                   \
-        long:           "long",                  \
-        unsigned long:  "unsigned long",         \
+        __GENERIC_LONG(long: "long", unsigned long: "unsigned long",) \
         void*:          "void*",                 \
         bool*:          "bool*",                 \
         u8*:            "u8*",                   \
@@ -117,8 +1201,7 @@ extern "C" {
         s64*:           "s64*",                  \
         f32*:           "f32*",                  \
         f64*:           "f64*",                  \
-        long*:          "long*",                 \
-        unsigned long*: "unsigned long*",        \
+        __GENERIC_LONG(long*: "long*", unsigned long*: "unsigned long*",) \
         default:        "other")
 // @DOC: paste, aka. expand and combine macros
 #define PASTE(a, b)                       a##b
@@ -222,7 +1305,7 @@ typedef enum pf_bg
 }pf_bg;
 
 // @DOC: doesnt print location, just printf
-#define _PF(...)		printf(__VA_ARGS__)
+#define _PF(...)		_PF_OUT(__VA_ARGS__)
 
 // @DOC: setting terminal output to a specific mode, text and background color
 #define PF_MODE(style, fg, bg)   _PF("\033[%d;%d;%dm", style, fg, bg)
@@ -238,30 +1321,37 @@ typedef enum pf_bg
 // -- print --
 
 // @DOC: print location, as in file and line, append anywhere that info is usefull
-#define _P_LOCATION(_file, _func, _line) PF_STYLE(PF_DIM, PF_WHITE); PF_STYLE(PF_ITALIC, PF_WHITE); _PF(" -> file: %s\n -> func: %s, line: %d\n", _file, _func, _line); PF_STYLE_RESET()
+#define _P_LOCATION(_file, _func, _line) _PF(PF_ESC_LOCATION __P_LOC_FMT PF_ESC_RESET, _file, _func, _line); PF_END()
 #define P_LOCATION() _P_LOCATION(__FILE__, __func__, __LINE__)
 // @DOC: print location on all P_ macros or not
 //       PF_IF_LOC() used in P/PF macros
 // #define PF_PRINT_LOCATION
+//       PF_LOC_FMT & PF_LOC_ARGS the same, but pasted into the macros format string and args
 #ifdef PF_PRINT_LOCATION
   #define PF_IF_LOC() P_LOCATION() 
   #define _PF_IF_LOC(_file, _func, _line) _P_LOCATION(_file, _func, _line) 
+  #define PF_LOC_FMT                      PF_ESC_LOCATION __P_LOC_FMT PF_ESC_RESET
+  #define _PF_LOC_ARGS(_file, _func, _line) , _file, _func, _line
 #else
   #define PF_IF_LOC()
   #define _PF_IF_LOC(_file, _func, _line)  
+  #define PF_LOC_FMT
+  #define _PF_LOC_ARGS(_file, _func, _line)
 #endif
+#define PF_LOC_ARGS _PF_LOC_ARGS(__FILE__, __func__, __LINE__)
 
 
 
 
-#define PF(...)		  printf(__VA_ARGS__); PF_IF_LOC()                                                      // @DOC: printf
-#define P(msg)		  _PF("%s\n", msg); PF_IF_LOC()                                                         // @DOC: pritnf with automatic \n
+#define PF(...)		  PF_IF_LEVEL(PF_LEVEL_DEBUG, _PF(__VA_ARGS__); PF_IF_LOC(); PF_END();)                                                     // @DOC: printf
+#define P(msg)		  PF_IF_LEVEL(PF_LEVEL_DEBUG, _PF("%s\n" PF_LOC_FMT, msg PF_LOC_ARGS); PF_END();)                                                     // @DOC: pritnf with automatic \n
 // #define P_INFO(msg) PF_COLOR(PF_YELLOW); _PF("[INFO] "); PF_STYLE_RESET(); _PF("%s\n", msg); P_LOCATION() // @DOC: P(), but always prints location
-#define P_INFO(...) PF_COLOR(PF_YELLOW); _PF("[INFO] "); PF_STYLE_RESET(); _PF(__VA_ARGS__); P_LOCATION() // @DOC: P(), but always prints location
+#define P_INFO(...) PF_IF_LEVEL(PF_LEVEL_INFO, _PF(PF_ESC_YELLOW "[INFO] " PF_ESC_RESET __VA_ARGS__); P_LOCATION();) // @DOC: P(), but always prints location
+#define P_WARN(...) PF_IF_LEVEL(PF_LEVEL_WARN, _PF(PF_ESC_PURPLE "[WARN] " PF_ESC_RESET __VA_ARGS__); P_LOCATION();) // @DOC: P_INFO(), but for warnings
 
 // @DOC: draw --- line as long as the current console is wide, only works on windows
 #if defined( _WIN32 )
-#define P_LINE()    { int w, h; io_util_get_console_size_win(&w, &h); for (int i = 0; i < w -1; ++i) { _PF("-"); } _PF("\n"); }
+#define P_LINE()    { int w, h; io_util_get_console_size_win(&w, &h); for (int i = 0; i < w -1; ++i) { _PF("-"); } _PF("\n"); PF_END(); }
 
 // @DOC: draw formatted string followed by line as wide as console
 //       example: P_LINE_STR("hello"); P_LINE_STR("str: %s", str);
@@ -281,32 +1371,346 @@ typedef enum pf_bg
 #define P_LINE_STR(_str)  P_ERR("P_LINE_STR() currently only supported in windows")                                                
 #endif
 
+// -- structured output --
+
+// @DOC: P_V() & P_ variable macros can write json lines or binary records instead of text, for log ingestion
+//       compile in with PF_STRUCTURED, select at runtime with pf_output_set() or env var PF_OUTPUT
+//       PF_OUTPUT_REGISTER() once, optionally PF_OUTPUT_INIT() to read PF_OUTPUT: "text", "json", "binary"
+//       every record is written with one _PF_WRITE(), no escape codes, P/PF/P_INFO/P_ERR etc. stay text
+//       records can go to their own file instead of stdout, see pf_output_set_file() or env var PF_OUTPUT_PATH,
+//       on stdout they are mixed with the text of the other macros
+//       json, one object per line:
+//         {"time":1234,"file":"main.c","func":"main","line":12,"name":"x","type":"s32","value":123}
+//         time is nanoseconds since epoch, u64/s64 are json numbers, f32/f64 are strings if nan/inf, pointers are strings
+//       binary, pf_struct_header_t, followed by name, type, file, func and value, no '\0'
+//         value is s64/u64/f64/u8 (bool & char) little endian, a string or nothing for kind PF_STRUCT_NONE
+//         every record starts with PF_STRUCT_MAGIC and its size, so readers can skip records,
+//         and find the next one by scanning for PF_STRUCT_MAGIC, if there is text in between
+#ifdef PF_STRUCTURED
+
+  typedef enum pf_output
+  {
+    PF_OUTPUT_TEXT,
+    PF_OUTPUT_JSON,
+    PF_OUTPUT_BINARY,
+  }pf_output;
+
+  #ifndef PF_OUTPUT_DEFAULT
+  #define PF_OUTPUT_DEFAULT PF_OUTPUT_JSON
+  #endif
+
+  // @DOC: kind of value in binary record
+  typedef enum pf_struct_kind
+  {
+    PF_STRUCT_NONE,   // no value, unknown type
+    PF_STRUCT_S64,
+    PF_STRUCT_U64,
+    PF_STRUCT_F64,
+    PF_STRUCT_BOOL,
+    PF_STRUCT_CHAR,
+    PF_STRUCT_STR,
+    PF_STRUCT_PTR,    // u64
+  }pf_struct_kind;
+
+  // @DOC: start of every binary record
+  #define PF_STRUCT_MAGIC "PFR1"
+
+  // @DOC: binary record header, size is the whole record including header
+  typedef struct
+  {
+    char magic[4];    // PF_STRUCT_MAGIC
+    u32  size;
+    u64  time;
+    u32  line;
+    u32  value_len;
+    u16  kind;        // pf_struct_kind
+    u16  name_len;
+    u16  type_len;
+    u16  file_len;
+    u16  func_len;
+    u16  pad[3];
+  }pf_struct_header_t;
+
+  // @DOC: defined in PF_OUTPUT_REGISTER()
+  extern pf_output __pf_output__;
+  // @DOC: file records get written to, NULL for stdout
+  extern FILE*     __pf_output_file__;
+
+  #define PF_OUTPUT_REGISTER()                                                \
+    pf_output __pf_output__      = PF_OUTPUT_DEFAULT;                         \
+    FILE*     __pf_output_file__ = NULL;
+
+  // @DOC: select output of P_V() & P_ variable macros
+  INLINE void pf_output_set(pf_output output)
+  {
+    #if defined(_WIN32)
+    if (output == PF_OUTPUT_BINARY && __pf_output_file__ == NULL) { fflush(stdout); _setmode(_fileno(stdout), _O_BINARY); }
+    #endif
+    __pf_output__ = output;
+  }
+  // @DOC: write records to file instead of stdout, NULL for stdout again
+  //       file: opened with "wb" for PF_OUTPUT_BINARY, records get fwrite()'n directly, not via PF_ASYNC
+  //       ! caller closes file, after setting NULL
+  INLINE void pf_output_set_file(FILE* file)
+  {
+    __pf_output_file__ = file;
+  }
+
+  // @DOC: read output from env var PF_OUTPUT, and file to write records to from PF_OUTPUT_PATH
+  #define PF_OUTPUT_INIT()                                                    \
+    {                                                                         \
+      const char* __pf_output_path = getenv("PF_OUTPUT_PATH");                \
+      if (__pf_output_path != NULL)                                           \
+      {                                                                       \
+        FILE* __pf_output_f = fopen(__pf_output_path, "wb");                  \
+        if (__pf_output_f == NULL) { P_ERR("couldnt open env var PF_OUTPUT_PATH: %s\n", __pf_output_path); } \
+        else { pf_output_set_file(__pf_output_f); }                           \
+      }                                                                       \
+      const char* __pf_output_env = getenv("PF_OUTPUT");                      \
+      if (__pf_output_env != NULL)                                            \
+      {                                                                       \
+        if      (strcmp(__pf_output_env, "text")   == 0) { pf_output_set(PF_OUTPUT_TEXT); }   \
+        else if (strcmp(__pf_output_env, "json")   == 0) { pf_output_set(PF_OUTPUT_JSON); }   \
+        else if (strcmp(__pf_output_env, "binary") == 0) { pf_output_set(PF_OUTPUT_BINARY); } \
+        else { P_ERR("env var PF_OUTPUT must be text, json or binary, not: %s\n", __pf_output_env); } \
+      }                                                                       \
+    }
+
+  // @DOC: record buffer, on the stack, only mallocs for records longer than local
+  typedef struct
+  {
+    char* data;
+    u32   len;
+    u32   cap;
+    char  local[512];
+  }pf_buf_t;
+
+  INLINE void __pf_buf_init(pf_buf_t* b)
+  {
+    b->data = b->local;
+    b->len  = 0;
+    b->cap  = sizeof(b->local);
+  }
+  INLINE void __pf_buf_free(pf_buf_t* b)
+  {
+    if (b->data != b->local) { free(b->data); }
+  }
+  // @DOC: make room for n more bytes, returns false if out of memory
+  INLINE bool __pf_buf_reserve(pf_buf_t* b, u32 n)
+  {
+    if (b->len + n <= b->cap) { return true; }
+    u32 cap = b->cap * 2;
+    while (cap < b->len + n) { cap *= 2; }
+    char* data = (char*)malloc(cap);
+    if (data == NULL) { return false; }
+    memcpy(data, b->data, b->len);
+    __pf_buf_free(b);
+    b->data = data;
+    b->cap  = cap;
+    return true;
+  }
+  INLINE void __pf_buf_push(pf_buf_t* b, const void* src, u32 n)
+  {
+    if (!__pf_buf_reserve(b, n)) { return; }
+    memcpy(b->data + b->len, src, n);
+    b->len += n;
+  }
+  INLINE void __pf_buf_str(pf_buf_t* b, const char* str)
+  {
+    __pf_buf_push(b, str, (u32)strlen(str));
+  }
+  // @DOC: push str as json string, with quotes
+  INLINE void __pf_buf_json_str(pf_buf_t* b, const char* str)
+  {
+    const char* hex = "0123456789abcdef";
+    __pf_buf_push(b, "\"", 1);
+    for (const u8* c = (const u8*)str; *c; ++c)
+    {
+      if (!__pf_buf_reserve(b, 6)) { return; }
+      char* out = b->data + b->len;
+      if      (*c == '"')  { out[0] = '\\'; out[1] = '"';  b->len += 2; }
+      else if (*c == '\\') { out[0] = '\\'; out[1] = '\\'; b->len += 2; }
+      else if (*c == '\n') { out[0] = '\\'; out[1] = 'n';  b->len += 2; }
+      else if (*c == '\t') { out[0] = '\\'; out[1] = 't';  b->len += 2; }
+      else if (*c < 0x20)  
+      { 
+        out[0] = '\\'; out[1] = 'u'; out[2] = '0'; out[3] = '0'; 
+        out[4] = hex[*c >> 4]; out[5] = hex[*c & 0xF]; 
+        b->len += 6; 
+      }
+      else { out[0] = (char)*c; b->len += 1; }
+    }
+    __pf_buf_push(b, "\"", 1);
+  }
+
+  // @DOC: start record, everything but the value
+  //       binary: header gets completed in __pf_struct_end()
+  INLINE void __pf_struct_begin(pf_buf_t* b, pf_struct_kind kind, const char* name, const char* type, const char* _file, const char* _func, const int _line)
+  {
+    __pf_buf_init(b);
+    if (__pf_output__ == PF_OUTPUT_BINARY)
+    {
+      pf_struct_header_t h;
+      memset(&h, 0, sizeof(h));
+      memcpy(h.magic, PF_STRUCT_MAGIC, 4);
+      h.time     = pf_time_real_ns();
+      h.line     = (u32)_line;
+      h.kind     = (u16)kind;
+      h.name_len = (u16)strlen(name);
+      h.type_len = (u16)strlen(type);
+      h.file_len = (u16)strlen(_file);
+      h.func_len = (u16)strlen(_func);
+      __pf_buf_push(b, &h, sizeof(h));
+      __pf_buf_push(b, name,  h.name_len);
+      __pf_buf_push(b, type,  h.type_len);
+      __pf_buf_push(b, _file, h.file_len);
+      __pf_buf_push(b, _func, h.func_len);
+      return;
+    }
+    char num[PF_FMT_MAX];
+    __pf_buf_str(b, "{\"time\":");
+    __pf_buf_push(b, num, pf_fmt_u64(num, pf_time_real_ns()));
+    __pf_buf_str(b, ",\"file\":");
+    __pf_buf_json_str(b, _file);
+    __pf_buf_str(b, ",\"func\":");
+    __pf_buf_json_str(b, _func);
+    __pf_buf_str(b, ",\"line\":");
+    __pf_buf_push(b, num, pf_fmt_s64(num, _line));
+    __pf_buf_str(b, ",\"name\":");
+    __pf_buf_json_str(b, name);
+    __pf_buf_str(b, ",\"type\":");
+    __pf_buf_json_str(b, type);
+    if (kind != PF_STRUCT_NONE) { __pf_buf_str(b, ",\"value\":"); }
+  }
+  // @DOC: finish and write record
+  INLINE void __pf_struct_end(pf_buf_t* b, u32 header_len)
+  {
+    if (__pf_output__ == PF_OUTPUT_BINARY)
+    {
+      if (b->len >= sizeof(pf_struct_header_t))
+      {
+        pf_struct_header_t* h = (pf_struct_header_t*)b->data;
+        h->size      = b->len;
+        h->value_len = b->len - header_len;
+      }
+    }
+    else { __pf_buf_str(b, "}\n"); }
+    if (__pf_output_file__ != NULL) { fwrite(b->data, 1, b->len, __pf_output_file__); }
+    else
+    {
+      _PF_WRITE(b->data, b->len);
+      PF_END();
+    }
+    __pf_buf_free(b);
+  }
+
+  // @DOC: write one record per variable, called by P_V() & P_ variable macros
+  #define __PF_STRUCT_BEGIN(_kind)  pf_buf_t b; __pf_struct_begin(&b, _kind, name, type, _file, _func, _line); u32 header_len = b.len
+  INLINE void __pf_struct_s64(const char* name, const char* type, s64 v, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_S64);
+    if (__pf_output__ == PF_OUTPUT_BINARY) { __pf_buf_push(&b, &v, sizeof(v)); }
+    else { char num[PF_FMT_MAX]; __pf_buf_push(&b, num, pf_fmt_s64(num, v)); }
+    __pf_struct_end(&b, header_len);
+  }
+  INLINE void __pf_struct_u64(const char* name, const char* type, u64 v, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_U64);
+    if (__pf_output__ == PF_OUTPUT_BINARY) { __pf_buf_push(&b, &v, sizeof(v)); }
+    else { char num[PF_FMT_MAX]; __pf_buf_push(&b, num, pf_fmt_u64(num, v)); }
+    __pf_struct_end(&b, header_len);
+  }
+  INLINE void __pf_struct_f64(const char* name, const char* type, f64 v, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_F64);
+    if (__pf_output__ == PF_OUTPUT_BINARY) { __pf_buf_push(&b, &v, sizeof(v)); }
+    else if (isnan(v)) { __pf_buf_str(&b, "\"nan\""); }
+    else if (isinf(v)) { __pf_buf_str(&b, v > 0 ? "\"inf\"" : "\"-inf\""); }
+    else { char num[PF_FMT_MAX]; __pf_buf_push(&b, num, pf_fmt_f64(num, v)); }
+    __pf_struct_end(&b, header_len);
+  }
+  // @DOC: binary is still f64, json has the shortest f32 text
+  INLINE void __pf_struct_f32(const char* name, const char* type, f32 v, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_F64);
+    if (__pf_output__ == PF_OUTPUT_BINARY) { f64 d = v; __pf_buf_push(&b, &d, sizeof(d)); }
+    else if (isnan(v)) { __pf_buf_str(&b, "\"nan\""); }
+    else if (isinf(v)) { __pf_buf_str(&b, v > 0 ? "\"inf\"" : "\"-inf\""); }
+    else { char num[PF_FMT_MAX]; __pf_buf_push(&b, num, pf_fmt_f32(num, v)); }
+    __pf_struct_end(&b, header_len);
+  }
+  INLINE void __pf_struct_bool(const char* name, const char* type, bool v, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_BOOL);
+    if (__pf_output__ == PF_OUTPUT_BINARY) { u8 u = v ? 1 : 0; __pf_buf_push(&b, &u, 1); }
+    else { __pf_buf_str(&b, STR_BOOL(v)); }
+    __pf_struct_end(&b, header_len);
+  }
+  INLINE void __pf_struct_char(const char* name, const char* type, char v, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_CHAR);
+    if (__pf_output__ == PF_OUTPUT_BINARY) { __pf_buf_push(&b, &v, 1); }
+    else { char str[2] = { v, '\0' }; __pf_buf_json_str(&b, str); }
+    __pf_struct_end(&b, header_len);
+  }
+  INLINE void __pf_struct_str(const char* name, const char* type, const char* v, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_STR);
+    if (v == NULL) { v = "(null)"; }
+    if (__pf_output__ == PF_OUTPUT_BINARY) { __pf_buf_str(&b, v); }
+    else { __pf_buf_json_str(&b, v); }
+    __pf_struct_end(&b, header_len);
+  }
+  INLINE void __pf_struct_ptr(const char* name, const char* type, const void* v, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_PTR);
+    if (__pf_output__ == PF_OUTPUT_BINARY) { u64 u = (u64)(uintptr_t)v; __pf_buf_push(&b, &u, sizeof(u)); }
+    else { char num[PF_FMT_MAX]; u32 len = pf_fmt_ptr(num +1, v); num[0] = '"'; num[len +1] = '"'; __pf_buf_push(&b, num, len +2); }
+    __pf_struct_end(&b, header_len);
+  }
+  INLINE void __pf_struct_none(const char* name, const char* type, const char* _file, const char* _func, const int _line)
+  {
+    __PF_STRUCT_BEGIN(PF_STRUCT_NONE);
+    __pf_struct_end(&b, header_len);
+  }
+  #undef __PF_STRUCT_BEGIN
+
+  // @DOC: write the structured record instead of the text, if not PF_OUTPUT_TEXT
+  //       PF_IF_STRUCTURED(__pf_struct_s64(...)) { text... }
+  #define PF_IF_STRUCTURED(...) if (__pf_output__ != PF_OUTPUT_TEXT) { __VA_ARGS__; } else
+
+#else   // PF_STRUCTURED
+  #define PF_OUTPUT_REGISTER()
+  #define PF_OUTPUT_INIT()
+  #define PF_IF_STRUCTURED(...)
+#endif  // PF_STRUCTURED
+
 // -- print variables --
 
 // @DOC: print the different types, e.g. P_INT(variable), highlights variable name cyan
-#define P_SIGNED(v) 	PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(": %d\n", (v)); PF_IF_LOC()
+#define P_SIGNED(v) 	PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_s64(#v, "signed", (v), __FILE__, __func__, __LINE__)) { char __pf_num[PF_FMT_MAX]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, #v, PF_FMT_STR(__pf_num, pf_fmt_s64, (v)) PF_LOC_ARGS); PF_END(); })
 #define P_INT(v) 	    P_SIGNED(v)
 #define P_S32(v) 	    P_SIGNED(v) 
 #define P_S16(v) 	    P_SIGNED(v) 
 #define P_S8(v) 	    P_SIGNED(v) 
-#define P_UNSIGNED(v) PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(": %u\n", (v)); PF_IF_LOC()
+#define P_UNSIGNED(v) PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_u64(#v, "unsigned", (v), __FILE__, __func__, __LINE__)) { char __pf_num[PF_FMT_MAX]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, #v, PF_FMT_STR(__pf_num, pf_fmt_u64, (v)) PF_LOC_ARGS); PF_END(); })
 // #define P_U64(u)      printf("|%s| %"PRId64"\n", #u, u)
-#define P_U64(v)      PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(": %"PRId64"\n", (v)); PF_IF_LOC()
+#define P_U64(v)      PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_u64(#v, "u64", (v), __FILE__, __func__, __LINE__)) { char __pf_num[PF_FMT_MAX]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, #v, PF_FMT_STR(__pf_num, pf_fmt_u64, (v)) PF_LOC_ARGS); PF_END(); })
 #define P_U32(v)      P_UNSIGNED(v)
 #define P_U16(v)      P_UNSIGNED(v)
 #define P_U8(v)       P_UNSIGNED(v)
 
-#define P_F32(v) 	    PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(": %f\n", (v)); PF_IF_LOC()
-#define P_F64(v) 	    P_F32(v) 
+#define P_F32(v) 	    PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_f32(#v, "f32", (f32)(v), __FILE__, __func__, __LINE__)) { char __pf_num[PF_FMT_MAX]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, #v, PF_FMT_STR(__pf_num, pf_fmt_f32, (f32)(v)) PF_LOC_ARGS); PF_END(); })
+#define P_F64(v) 	    PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_f64(#v, "f64", (f64)(v), __FILE__, __func__, __LINE__)) { char __pf_num[PF_FMT_MAX]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, #v, PF_FMT_STR(__pf_num, pf_fmt_f64, (f64)(v)) PF_LOC_ARGS); PF_END(); })
 // #define P_U64(u)   printf("|%s| %llu\n", #u, u)
 
-#define P_BOOL(v) 	  PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(": %s\n", STR_BOOL(v)); PF_IF_LOC()
+#define P_BOOL(v) 	  PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_bool(#v, "bool", (v), __FILE__, __func__, __LINE__)) { _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, #v, STR_BOOL(v) PF_LOC_ARGS); PF_END(); })
 
-#define P_CHAR(v) 	  PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(": '%c'\n", (char)(v)); PF_IF_LOC()
-#define P_STR(v) 	    PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(": \"%s\"\n", (v)); PF_IF_LOC() 
-#define P_TXT(v)      PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(":\n%s\n", (v)); PF_IF_LOC()    
+#define P_CHAR(v) 	  PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_char(#v, "char", (char)(v), __FILE__, __func__, __LINE__)) { _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": '%c'\n" PF_LOC_FMT, #v, (char)(v) PF_LOC_ARGS); PF_END(); })
+#define P_STR(v) 	    PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_str(#v, "str", (v), __FILE__, __func__, __LINE__)) { _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": \"%s\"\n" PF_LOC_FMT, #v, (v) PF_LOC_ARGS); PF_END(); })
+#define P_TXT(v)      PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_str(#v, "str", (v), __FILE__, __func__, __LINE__)) { _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ":\n%s\n" PF_LOC_FMT, #v, (v) PF_LOC_ARGS); PF_END(); })
 
-#define P_PTR(v) 	    PF_COLOR(PF_CYAN); _PF("%s", #v); PF_STYLE_RESET(); _PF(": %p\n", (v)); PF_IF_LOC()
+#define P_PTR(v) 	    PF_IF_LEVEL(PF_LEVEL_DEBUG, PF_IF_STRUCTURED(__pf_struct_ptr(#v, "ptr", (v), __FILE__, __func__, __LINE__)) { char __pf_num[PF_FMT_MAX]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, #v, PF_FMT_STR(__pf_num, pf_fmt_ptr, (v)) PF_LOC_ARGS); PF_END(); })
 
 // @DOC: print member of a flag, i.e. P_FLAG_MEMBER(my_flag, MY_FLAG_ENUM) -> get printed red/green
 //       used for printting whole flags possible flags i.e.:
@@ -320,7 +1724,7 @@ typedef enum pf_bg
 //         _PF_IF_LOC(_file, _func, _line);
 //       }
 //       #define P_MY_FLAG(_f) audio_print_my_flag(_f, #_f, __FILE__, __func__, __LINE__)
-#define P_FLAG_MEMBER(_f, _flag)     PF_COLOR(HAS_FLAG(_f, _flag)  ? PF_GREEN : PF_RED); _PF("%s", #_flag); PF_STYLE_RESET(); _PF(" | ")
+#define P_FLAG_MEMBER(_f, _flag)     _PF("%s%s" PF_ESC_RESET " | ", HAS_FLAG(_f, _flag) ? PF_ESC_GREEN : PF_ESC_RED, #_flag)
 
 
 // #define P_V(v) _Generic((v),                              \x
@@ -347,9 +1751,18 @@ typedef enum pf_bg
 // @DOC: P_V(var) prints variable type-generic
 //       s32 i = 123; P_V(i);
 //       -> s32|i: 123
-#define __P_FUNC(_name, _type, _pf_type)                                                                                              \
+//       _fmt: pf_fmt_ function turning v into text
+//       _struct: __pf_struct_ writer used with PF_STRUCTURED
+#define __P_FUNC(_name, _type, _fmt, _struct)                                                                                         \
 INLINE void _name(const char* _file, const char* _func, const int _line, const char* name, const char* type, _type v)                 \
-{PF_COLOR(PF_YELLOW); _PF("%s", type); PF_COLOR(PF_WHITE); _PF("|"); PF_COLOR(PF_CYAN); _PF("%s", name); PF_STYLE_RESET(); _PF(": %"_pf_type"\n", v); _PF_IF_LOC(_file, _func, _line); }
+{                                                                                                                                     \
+  PF_IF_STRUCTURED(_struct(name, type, v, _file, _func, _line))                                                                       \
+  {                                                                                                                                   \
+    char num[PF_FMT_MAX];                                                                                                             \
+    _PF(PF_ESC_YELLOW "%s" PF_ESC_WHITE "|" PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, type, name, PF_FMT_STR(num, _fmt, v) _PF_LOC_ARGS(_file, _func, _line)); \
+    PF_END();                                                                                                                         \
+  }                                                                                                                                   \
+}
 
 #ifdef _MSC_VER // gcc doesnt knwo this warning, GCC diagnostic push works in clang/msvc too
 #pragma GCC diagnostic push
@@ -359,17 +1772,18 @@ INLINE void _name(const char* _file, const char* _func, const int _line, const c
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #endif
 
-INLINE void __P_UNKNOWN(const char* _file, const char* _func, const int _line, const char* name, const char* type, ...)     {PF_COLOR(PF_YELLOW); _PF("%s", type); PF_COLOR(PF_WHITE); _PF("|"); PF_COLOR(PF_CYAN); _PF("%s", name); PF_STYLE_RESET(); _PF(": UNKNOWN TYPE\n");             _PF_IF_LOC(_file, _func, _line); }
+INLINE void __P_UNKNOWN(const char* _file, const char* _func, const int _line, const char* name, const char* type, ...)     { PF_IF_STRUCTURED(__pf_struct_none(name, type, _file, _func, _line)) { _PF(PF_ESC_YELLOW "%s" PF_ESC_WHITE "|" PF_ESC_CYAN "%s" PF_ESC_RESET ": UNKNOWN TYPE\n" PF_LOC_FMT, type, name _PF_LOC_ARGS(_file, _func, _line));             PF_END(); } }
 
-INLINE void __P_BOOL(   const char* _file, const char* _func, const int _line, const char* name, const char* type, bool v)  {PF_COLOR(PF_YELLOW); _PF("%s", type); PF_COLOR(PF_WHITE); _PF("|"); PF_COLOR(PF_CYAN); _PF("%s", name); PF_STYLE_RESET(); _PF(": %s\n", v ? "true" : "false"); _PF_IF_LOC(_file, _func, _line); }
-__P_FUNC(__P_UNSIGNED,  u32,            "u")
-__P_FUNC(__P_U64,       u64,            PRId64)
-__P_FUNC(__P_SIGNED,    s32,            "d")
-__P_FUNC(__P_S64,       s64,            "lld")
-__P_FUNC(__P_LONG,      long,           "ld")
-__P_FUNC(__P_ULONG,     unsigned long,  "lu")
-__P_FUNC(__P_FLOAT,     f64,            "f")
-__P_FUNC(__P_POINTER,   void*,          "p")
+INLINE void __P_BOOL(   const char* _file, const char* _func, const int _line, const char* name, const char* type, bool v)  { PF_IF_STRUCTURED(__pf_struct_bool(name, type, v, _file, _func, _line)) { _PF(PF_ESC_YELLOW "%s" PF_ESC_WHITE "|" PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, type, name, v ? "true" : "false" _PF_LOC_ARGS(_file, _func, _line)); PF_END(); } }
+__P_FUNC(__P_UNSIGNED,  u32,            pf_fmt_u64, __pf_struct_u64)
+__P_FUNC(__P_U64,       u64,            pf_fmt_u64, __pf_struct_u64)
+__P_FUNC(__P_SIGNED,    s32,            pf_fmt_s64, __pf_struct_s64)
+__P_FUNC(__P_S64,       s64,            pf_fmt_s64, __pf_struct_s64)
+__P_FUNC(__P_LONG,      long,           pf_fmt_s64, __pf_struct_s64)
+__P_FUNC(__P_ULONG,     unsigned long,  pf_fmt_u64, __pf_struct_u64)
+__P_FUNC(__P_F32,       f32,            pf_fmt_f32, __pf_struct_f32)
+__P_FUNC(__P_FLOAT,     f64,            pf_fmt_f64, __pf_struct_f64)
+__P_FUNC(__P_POINTER,   void*,          pf_fmt_ptr, __pf_struct_ptr)
 
 // INLINE void __P_UNSIGNED(const char* _file, const char* _func, const int _line, const char* name, const char* type, u32 v)   {PF_COLOR(PF_YELLOW); _PF("%s", type); PF_COLOR(PF_WHITE); _PF("|"); PF_COLOR(PF_CYAN); _PF("%s", name); PF_STYLE_RESET(); _PF(": %u\n", v);                    _PF_IF_LOC(_file, _func, _line); }
 // INLINE void __P_U64(    const char* _file, const char* _func, const int _line, const char* name, const char* type, u64 v)   {PF_COLOR(PF_YELLOW); _PF("%s", type); PF_COLOR(PF_WHITE); _PF("|"); PF_COLOR(PF_CYAN); _PF("%s", name); PF_STYLE_RESET(); _PF(": %"PRId64"\n", v);             _PF_IF_LOC(_file, _func, _line); }
@@ -379,7 +1793,7 @@ __P_FUNC(__P_POINTER,   void*,          "p")
 // INLINE void __P_S64(    const char* _file, const char* _func, const int _line, const char* name, const char* type, s64 v)   {PF_COLOR(PF_YELLOW); _PF("%s", type); PF_COLOR(PF_WHITE); _PF("|"); PF_COLOR(PF_CYAN); _PF("%s", name); PF_STYLE_RESET(); _PF(": %lld\n", v);                  _PF_IF_LOC(_file, _func, _line); }
 // INLINE void __P_FLOAT(  const char* _file, const char* _func, const int _line, const char* name, const char* type, f64 v) 	{PF_COLOR(PF_YELLOW); _PF("%s", type); PF_COLOR(PF_WHITE); _PF("|"); PF_COLOR(PF_CYAN); _PF("%s", name); PF_STYLE_RESET(); _PF(": %f\n", v);                    _PF_IF_LOC(_file, _func, _line); }
 // INLINE void __P_POINTER(const char* _file, const char* _func, const int _line, const char* name, const char* type, void* v) {PF_COLOR(PF_YELLOW); _PF("%s", type); PF_COLOR(PF_WHITE); _PF("|"); PF_COLOR(PF_CYAN); _PF("%s", name); PF_STYLE_RESET(); _PF(": %p\n", v);                    _PF_IF_LOC(_file, _func, _line); }
-#define P_V(v) _Generic((v),                        \
+#define P_V(v) PF_IF_LEVEL(PF_LEVEL_DEBUG, _Generic((v), \
         bool:           __P_BOOL,                   \
         u8:             __P_UNSIGNED,               \
         u16:            __P_UNSIGNED,               \
@@ -389,10 +1803,9 @@ __P_FUNC(__P_POINTER,   void*,          "p")
         s16:            __P_SIGNED,                 \
         s32:            __P_SIGNED,                 \
         s64:            __P_S64,                    \
-        f32:            __P_FLOAT,                  \
+        f32:            __P_F32,                    \
         f64:            __P_FLOAT,                  \
-        long:           __P_LONG,                   \
-        unsigned long:  __P_ULONG,                  \
+        __GENERIC_LONG(long: __P_LONG, unsigned long: __P_ULONG,) \
         void*:          __P_POINTER,                \
         bool*:          __P_POINTER,                \
         u8*:            __P_POINTER,                \
@@ -405,9 +1818,8 @@ __P_FUNC(__P_POINTER,   void*,          "p")
         s64*:           __P_POINTER,                \
         f32*:           __P_POINTER,                \
         f64*:           __P_POINTER,                \
-        long*:          __P_POINTER,                \
-        unsigned long*: __P_POINTER,                \
-        default:        __P_UNKNOWN)(__FILE__, __func__, __LINE__, #v, STR_TYPE(v), v)
+        __GENERIC_LONG(long*: __P_POINTER, unsigned long*: __P_POINTER,) \
+        default:        __P_UNKNOWN)(__FILE__, __func__, __LINE__, #v, STR_TYPE(v), v);)
 
 // @DOC: test P_V() and STR_TYPE() macros
 INLINE void TEST_P_V()
@@ -451,19 +1863,19 @@ INLINE void TEST_P_V()
 
 // always print location
 
-#define P_LOC_INT(v)  P_INT(v);  P_LOCATION()
-#define P_LOC_S32(v) 	P_S32(v);  P_LOCATION() 
-#define P_LOC_S16(v) 	P_S16(v);  P_LOCATION() 
-#define P_LOC_S8(v) 	P_S8(v);   P_LOCATION()
-#define P_LOC_U8(v)   P_U8(v);   P_LOCATION()
-#define P_LOC_U32(v)  P_U32(v);  P_LOCATION()
-#define P_LOC_U16(v)  P_U16(v);  P_LOCATION() 
-#define P_LOC_F32(v) 	P_F32(v);  P_LOCATION()
-#define P_LOC_BOOL(v) P_BOOL(v); P_LOCATION()
-#define P_LOC_CHAR(v) P_CHAR(v); P_LOCATION()
-#define P_LOC_STR(v) 	P_STR(v);  P_LOCATION() 
-#define P_LOC_TXT(v)  P_TXT(v);  P_LOCATION()    
-#define P_LOC_PTR(v)  P_PTR(v);  P_LOCATION()
+#define P_LOC_INT(v)  PF_IF_LEVEL(PF_LEVEL_DEBUG, P_INT(v);  P_LOCATION();)
+#define P_LOC_S32(v) 	PF_IF_LEVEL(PF_LEVEL_DEBUG, P_S32(v);  P_LOCATION();)
+#define P_LOC_S16(v) 	PF_IF_LEVEL(PF_LEVEL_DEBUG, P_S16(v);  P_LOCATION();)
+#define P_LOC_S8(v) 	PF_IF_LEVEL(PF_LEVEL_DEBUG, P_S8(v);   P_LOCATION();)
+#define P_LOC_U8(v)   PF_IF_LEVEL(PF_LEVEL_DEBUG, P_U8(v);   P_LOCATION();)
+#define P_LOC_U32(v)  PF_IF_LEVEL(PF_LEVEL_DEBUG, P_U32(v);  P_LOCATION();)
+#define P_LOC_U16(v)  PF_IF_LEVEL(PF_LEVEL_DEBUG, P_U16(v);  P_LOCATION();)
+#define P_LOC_F32(v) 	PF_IF_LEVEL(PF_LEVEL_DEBUG, P_F32(v);  P_LOCATION();)
+#define P_LOC_BOOL(v) PF_IF_LEVEL(PF_LEVEL_DEBUG, P_BOOL(v); P_LOCATION();)
+#define P_LOC_CHAR(v) PF_IF_LEVEL(PF_LEVEL_DEBUG, P_CHAR(v); P_LOCATION();)
+#define P_LOC_STR(v) 	PF_IF_LEVEL(PF_LEVEL_DEBUG, P_STR(v);  P_LOCATION();)
+#define P_LOC_TXT(v)  PF_IF_LEVEL(PF_LEVEL_DEBUG, P_TXT(v);  P_LOCATION();)
+#define P_LOC_PTR(v)  PF_IF_LEVEL(PF_LEVEL_DEBUG, P_PTR(v);  P_LOCATION();)
 
 // --- binary ---
 
@@ -478,29 +1890,138 @@ INLINE void TEST_P_V()
   ((byte) & 0x02 ? '1' : '0'), \
   ((byte) & 0x01 ? '1' : '0') 
 
+// @DOC: lowest bytes of v as binary, msb first, bytes separated by '.', "00000001.00000000"
+//       buf needs room for bytes * 9 chars
+INLINE u32 __pf_fmt_bin_bytes(char* buf, u64 v, u32 bytes)
+{
+  char* p = buf;
+  for (s32 i = (s32)bytes -1; i >= 0; --i)
+  {
+    __pf_fmt_byte_bin(p, (u8)(v >> (i * 8)));
+    p += 8;
+    if (i > 0) { *p++ = '.'; }
+  }
+  return (u32)(p - buf);
+}
+
 // @DOC: print u8/s8 as binary without name 
-#define PF_BIN8(v)  printf(""BYTE_TO_BINARY_PATTERN"\n", BYTE_TO_BINARY(v)); 
+#define PF_BIN8(v)  { char __pf_bin[40]; _PF("%s\n", PF_FMT_STR(__pf_bin, __pf_fmt_bin_bytes, (u64)(v), 1)); PF_END(); }
 
 // @DOC: print u16/s16 as binary with name 
-#define P_BIN8(v)   PF_COLOR(PF_CYAN); printf("%s", #v); PF_STYLE_RESET(); printf(": "); PF_BIN8(v); PF_IF_LOC();
+#define P_BIN8(v)   PF_IF_LEVEL(PF_LEVEL_DEBUG, char __pf_bin[40]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, \
+                     #v, PF_FMT_STR(__pf_bin, __pf_fmt_bin_bytes, (u64)(v), 1) PF_LOC_ARGS); PF_END();)
 // @DOC: print u16/s16 as binary without name 
-#define PF_BIN16(v)  printf(""BYTE_TO_BINARY_PATTERN"."BYTE_TO_BINARY_PATTERN"\n", \
-                     BYTE_TO_BINARY(v>>8), BYTE_TO_BINARY(v)); 
+#define PF_BIN16(v)  { char __pf_bin[40]; _PF("%s\n", PF_FMT_STR(__pf_bin, __pf_fmt_bin_bytes, (u64)(v), 2)); PF_END(); }
 
 // @DOC: print u16/s16 as binary with name 
-#define P_BIN16(v)   PF_COLOR(PF_CYAN); printf("%s", #v); PF_STYLE_RESET(); printf(": "); PF_BIN16(v); PF_IF_LOC();
+#define P_BIN16(v)   PF_IF_LEVEL(PF_LEVEL_DEBUG, char __pf_bin[40]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, \
+                     #v, PF_FMT_STR(__pf_bin, __pf_fmt_bin_bytes, (u64)(v), 2) PF_LOC_ARGS); PF_END();)
 // @DOC: print u32/s32 as binary without name 
-#define PF_BIN32(v)  printf(""BYTE_TO_BINARY_PATTERN"."BYTE_TO_BINARY_PATTERN"."BYTE_TO_BINARY_PATTERN"."BYTE_TO_BINARY_PATTERN"\n", \
-                     BYTE_TO_BINARY(v>>24), BYTE_TO_BINARY(v>>16), BYTE_TO_BINARY(v>>8), BYTE_TO_BINARY(v)); 
+#define PF_BIN32(v)  { char __pf_bin[40]; _PF("%s\n", PF_FMT_STR(__pf_bin, __pf_fmt_bin_bytes, (u64)(v), 4)); PF_END(); }
 // @DOC: print u32/s32 as binary with name 
-#define P_BIN32(v)   PF_COLOR(PF_CYAN); printf("%s", #v); PF_STYLE_RESET(); printf(": "); PF_BIN32(v); PF_IF_LOC();
+#define P_BIN32(v)   PF_IF_LEVEL(PF_LEVEL_DEBUG, char __pf_bin[40]; _PF(PF_ESC_CYAN "%s" PF_ESC_RESET ": %s\n" PF_LOC_FMT, \
+                     #v, PF_FMT_STR(__pf_bin, __pf_fmt_bin_bytes, (u64)(v), 4) PF_LOC_ARGS); PF_END();)
+
+// @DOC: print pf_dump_fmt() of data with name and size, in one write, see pf_dump_fmt()
+INLINE void __pf_dump_print(const char* name, const void* data, u64 len, pf_dump_base base, u32 group, u32 per_line, const char* _file, const char* _func, const int _line)
+{
+  const char name_esc[]  = PF_ESC_CYAN;
+  const char reset_esc[] = PF_ESC_RESET;
+  u64 name_len = strlen(name);
+  u64 size     = name_len + PF_FMT_MAX + 32 + pf_dump_size(len, base, group, per_line);
+#ifdef PF_PRINT_LOCATION
+  const char loc_esc[] = PF_ESC_LOCATION;
+  u64 file_len = strlen(_file);
+  u64 func_len = strlen(_func);
+  size += file_len + func_len + PF_FMT_MAX + 64;
+#else
+  (void)_file; (void)_func; (void)_line;
+#endif
+  
+  char  local[4096];
+  char* buf = size <= sizeof(local) ? local : (char*)malloc(size);
+  if (buf == NULL) { P_ERR("failed to malloc %" PRIu64 " bytes for dump of %s\n", size, name); return; }
+  char* p = buf;
+  memcpy(p, name_esc, sizeof(name_esc) -1);   p += sizeof(name_esc) -1;
+  memcpy(p, name, name_len);                  p += name_len;
+  memcpy(p, reset_esc, sizeof(reset_esc) -1); p += sizeof(reset_esc) -1;
+  memcpy(p, ": ", 2);                         p += 2;
+  p += pf_fmt_u64(p, len);
+  memcpy(p, " bytes\n", 7);                   p += 7;
+  p += pf_dump_fmt(p, data, len, base, group, per_line);
+#ifdef PF_PRINT_LOCATION
+  memcpy(p, loc_esc, sizeof(loc_esc) -1);     p += sizeof(loc_esc) -1;
+  memcpy(p, " -> file: ", 10);                p += 10;
+  memcpy(p, _file, file_len);                 p += file_len;
+  memcpy(p, "\n -> func: ", 11);              p += 11;
+  memcpy(p, _func, func_len);                 p += func_len;
+  memcpy(p, ", line: ", 8);                   p += 8;
+  p += pf_fmt_s64(p, _line);
+  *p++ = '\n';
+  memcpy(p, reset_esc, sizeof(reset_esc) -1); p += sizeof(reset_esc) -1;
+#endif
+  _PF_WRITE(buf, (u32)(p - buf));
+  PF_END();
+  if (buf != local) { free(buf); }
+}
+// @DOC: print any amount of bytes as hex / binary, e.g. P_HEX_DUMP(packet, packet_len)
+//       P_DUMP() takes group & per_line, see pf_dump_fmt()
+#define P_HEX_DUMP(_data, _len)                       PF_IF_LEVEL(PF_LEVEL_DEBUG, __pf_dump_print(#_data, _data, _len, PF_DUMP_HEX, 0, 0, __FILE__, __func__, __LINE__);)
+#define P_BIN_DUMP(_data, _len)                       PF_IF_LEVEL(PF_LEVEL_DEBUG, __pf_dump_print(#_data, _data, _len, PF_DUMP_BIN, 0, 0, __FILE__, __func__, __LINE__);)
+#define P_DUMP(_data, _len, _base, _group, _per_line) PF_IF_LEVEL(PF_LEVEL_DEBUG, __pf_dump_print(#_data, _data, _len, _base, _group, _per_line, __FILE__, __func__, __LINE__);)
+
+// @DOC: check the pf_fmt_ functions against printf, then time both on values typical for P_ macros
+//       n: amount of values, e.g. 1000000
+INLINE void TEST_PF_FMT(u32 n)
+{
+  char a[PF_FMT_MAX], b[PF_FMT_MAX];
+  u32  errors = 0;
+  u64  x      = 88172645463325252ull;   // xorshift
+  for (u32 i = 0; i < n; ++i)
+  {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    s64 s = (s64)x >> (x & 63);
+    f64 d; memcpy(&d, &x, sizeof(d));
+    f32 f; memcpy(&f, &x, sizeof(f));
+    PF_FMT_STR(a, pf_fmt_s64, s); snprintf(b, sizeof(b), "%" PRId64, s);
+    if (strcmp(a, b) != 0) { errors++; }
+    PF_FMT_STR(a, pf_fmt_hex, x, 16); snprintf(b, sizeof(b), "%016" PRIx64, x);
+    if (strcmp(a, b) != 0) { errors++; }
+    if (!isnan(d)) { PF_FMT_STR(a, pf_fmt_f64, d); if (strtod(a, NULL) != d) { errors++; } }
+    if (!isnan(f)) { PF_FMT_STR(a, pf_fmt_f32, f); if (strtof(a, NULL) != f) { errors++; } }
+  }
+  PF("pf_fmt: %u values, %u errors\n", n, errors);
+
+  // time, values like loop counters, sizes and positions
+  #define __TEST_PF_FMT_TIME(_name, ...)                                          \
+  {                                                                             \
+    u64 sum = 0;                                                                \
+    u64 t0  = pf_time_ns();                                                     \
+    for (u32 i = 0; i < n; ++i) { sum += (u64)(__VA_ARGS__) + (u8)a[0]; }       \
+    f64 ns  = (f64)(pf_time_ns() - t0);                                         \
+    PF("%-10s %6.1f ns %s\n", _name, ns / n, sum == 0 ? " " : "");             \
+  }
+  __TEST_PF_FMT_TIME("pf u64",    pf_fmt_u64(a, (u64)i * 7919));
+  __TEST_PF_FMT_TIME("printf u64", snprintf(a, sizeof(a), "%" PRIu64, (u64)i * 7919));
+  __TEST_PF_FMT_TIME("pf s32",    pf_fmt_s64(a, (s32)i - (s32)(n / 2)));
+  __TEST_PF_FMT_TIME("printf s32", snprintf(a, sizeof(a), "%d", (s32)i - (s32)(n / 2)));
+  __TEST_PF_FMT_TIME("pf f32",    pf_fmt_f32(a, (f32)i * 0.25f + 0.1f));
+  __TEST_PF_FMT_TIME("printf f32", snprintf(a, sizeof(a), "%f", (f32)i * 0.25f + 0.1f));
+  __TEST_PF_FMT_TIME("pf f64",    pf_fmt_f64(a, (f64)i * 0.001));
+  __TEST_PF_FMT_TIME("printf f64", snprintf(a, sizeof(a), "%.17g", (f64)i * 0.001));
+  __TEST_PF_FMT_TIME("pf hex",    pf_fmt_hex(a, (u64)(i * 0x9E3779B9ull), 8));
+  __TEST_PF_FMT_TIME("printf hex", snprintf(a, sizeof(a), "%08" PRIx64, (u64)(i * 0x9E3779B9ull)));
+  __TEST_PF_FMT_TIME("pf bin",    pf_fmt_bin(a, i, 16));
+  __TEST_PF_FMT_TIME("printf bin", snprintf(a, sizeof(a), BYTE_TO_BINARY_PATTERN BYTE_TO_BINARY_PATTERN, BYTE_TO_BINARY(i >> 8), BYTE_TO_BINARY(i)));
+  #undef __TEST_PF_FMT_TIME
+}
 
 // -- debug --
 
 // @DOC: check f32/float is nan
 #define F32_NAN(v)  (isnan(v) != 0)
 // @DOC: print if f32/float is nan
-#define P_NAN(v)    { if (F32_NAN(v)) { _PF("%s is nan\n", #v); PF_IF_LOC(); } }
+#define P_NAN(v)    PF_IF_LEVEL(PF_LEVEL_DEBUG, if (F32_NAN(v)) { _PF("%s is nan\n", #v); PF_IF_LOC(); PF_END(); })
 
 // @DOC: print out all macros once for testing
 #define GLOBAL_TEST_P_MACROS() { s32 int_32 = 0; s16 int_16 = 0; s8 int_8 = 0; u32 uint_32 = 0; u16 uint_16 = 0; u8 uint_8  = 0; f32 floating_point = 0.5f; bool b = true; s8 s_byte = '?'; char* str = "hello, there"; char* txt = "this is very textual\nmhhh yess\nlicrictically intricate"; \
@@ -626,9 +2147,13 @@ P_INT(int_32); P_S32(int_32); P_S16(int_16); P_S8(int_8); P_U32(uint_32); P_U16(
 #define PF(...)		                	
 #define P(...)
 #define P_INFO(...)   
+#define P_WARN(...)   
 #define P_LINE()
 #define P_LINE_STR(...)
 
+#define PF_OUTPUT_REGISTER()
+#define PF_OUTPUT_INIT()
+
 #define P_SIGNED(v) 	
 #define P_INT(v) 	    
 #define P_S32(v) 	    
@@ -655,6 +2180,10 @@ P_INT(int_32); P_S32(int_32); P_S16(int_16); P_S8(int_8); P_U32(uint_32); P_U16(
 
 #define P_FLAG_MEMBER(...)
 
+#define P_HEX_DUMP(...)
+#define P_BIN_DUMP(...)
+#define P_DUMP(...)
+
 #define BYTE_TO_BINARY_PATTERN "%c%c%c%c%c%c%c%c"
 #define BYTE_TO_BINARY(byte)   \
   ((byte) & 0x80 ? '1' : '0'), \
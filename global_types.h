@@ -78,6 +78,12 @@ typedef uint16_t    u16;
 typedef uint32_t    u32;
 typedef uint64_t    u64;
 
+// @DOC: on 64 bit linux/bsd int64_t is long, so s64 & long are the same type for _Generic()
+//       on windows, macos and 32 bit they are different types
+#if defined(__LP64__) && !defined(__APPLE__)
+  #define GLOBAL_S64_IS_LONG
+#endif
+
 typedef float 			f32;
 typedef double			f64;
 
@@ -90,6 +96,38 @@ typedef void (empty_callback)(void);
 #  define INLINE static inline __attribute((always_inline))
 #endif
 
+// @DOC: thread local storage works different in c, c++ and msvc
+//       THREAD_LOCAL int x;  -> every thread has its own x
+#if defined(__cplusplus)
+#  define THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#  define THREAD_LOCAL __declspec(thread)
+#else
+#  define THREAD_LOCAL _Thread_local
+#endif
+
+// @DOC: atomic operations on plain 32/64 bit integers, gcc/clang builtins or msvc intrinsics
+//       ATOMIC_LOAD(&x), ATOMIC_STORE(&x, v)
+//       ATOMIC_FETCH_ADD(&x, v)           -> returns value before adding
+//       ATOMIC_CAS(&x, &expected, v)      -> true if x was expected and is now v, 
+//                                            otherwise expected gets set to x
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+INLINE bool __atomic_cas_32(volatile long* p, long* expected, long v)
+{ long old = _InterlockedCompareExchange(p, v, *expected); if (old == *expected) { return true; } *expected = old; return false; }
+INLINE bool __atomic_cas_64(volatile __int64* p, __int64* expected, __int64 v)
+{ __int64 old = _InterlockedCompareExchange64(p, v, *expected); if (old == *expected) { return true; } *expected = old; return false; }
+#  define ATOMIC_LOAD(p)              (sizeof(*(p)) == 8 ? (u64)_InterlockedOr64((volatile __int64*)(p), 0) : (u64)(u32)_InterlockedOr((volatile long*)(p), 0))
+#  define ATOMIC_STORE(p, v)          (sizeof(*(p)) == 8 ? (void)_InterlockedExchange64((volatile __int64*)(p), (__int64)(v)) : (void)_InterlockedExchange((volatile long*)(p), (long)(v)))
+#  define ATOMIC_FETCH_ADD(p, v)      (sizeof(*(p)) == 8 ? (u64)_InterlockedExchangeAdd64((volatile __int64*)(p), (__int64)(v)) : (u64)(u32)_InterlockedExchangeAdd((volatile long*)(p), (long)(v)))
+#  define ATOMIC_CAS(p, expected, v)  (sizeof(*(p)) == 8 ? __atomic_cas_64((volatile __int64*)(p), (__int64*)(expected), (__int64)(v)) : __atomic_cas_32((volatile long*)(p), (long*)(expected), (long)(v)))
+#else
+#  define ATOMIC_LOAD(p)              __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#  define ATOMIC_STORE(p, v)          __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#  define ATOMIC_FETCH_ADD(p, v)      __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+#  define ATOMIC_CAS(p, expected, v)  __atomic_compare_exchange_n((p), (expected), (v), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#endif
+
 // ---- helper ----
 
 // @DOC: make number with bit a set 
@@ -0,0 +1,240 @@
+#ifndef GLOBAL_POOL_ALLOC_H
+#define GLOBAL_POOL_ALLOC_H
+
+
+
+#include "global.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: header in front of every chunk of a pool_alloc_t
+//       chunks get chained via prev, newest chunk is alloc->chunk
+typedef struct pool_chunk_t
+{
+  struct pool_chunk_t* prev;  // previous, already used up chunk, NULL if first
+}pool_chunk_t;
+
+// @DOC: fixed size object pool, alloc and free are O(1)
+//       free'd elements are kept in an intrusive free list,
+//       the pointer to the next free element is stored inside the free'd element
+typedef struct
+{
+  u8*   data;                 // elements of current chunk
+  u32   elem_size;            // size of one element, rounded up to POOL_ALLOC_ALIGN
+  u32   count;                // elements per chunk
+  u32   used;                 // elements in current chunk handed out at least once
+  void* free_list;            // last free'd element, NULL if none
+
+  u32   alloc_count;          // elements currently allocated
+
+  // @DOC: only used in growable mode, see pool_init_growable()
+  bool  growable;
+  u32   max_chunks;           // cap for chunk_count, 0 is no cap
+  u32   chunk_count;
+  pool_chunk_t* chunk;        // current chunk
+
+}pool_alloc_t;
+
+// @DOC: alignment of every element, can be defined before including
+//       needs to be power of 2 and at least sizeof(void*)
+#ifndef POOL_ALLOC_ALIGN
+#define POOL_ALLOC_ALIGN  sizeof(void*)
+#endif
+// @DOC: offset of first element in chunk, keeps elements aligned to BUMP_MAX_ALIGN, see bump_alloc.h
+#define POOL_CHUNK_HEADER_SIZE  ((sizeof(pool_chunk_t) + BUMP_MAX_ALIGN -1) & ~(BUMP_MAX_ALIGN -1))
+
+// @DOC: allocates a new chunk and chains it in front of the current one
+//       returns false if max_chunks would be exceeded
+INLINE bool pool_add_chunk(pool_alloc_t* alloc)
+{
+  if (alloc->max_chunks > 0 && alloc->chunk_count >= alloc->max_chunks) { return false; }
+
+  void* mem = NULL;
+  MALLOC(mem, POOL_CHUNK_HEADER_SIZE + (size_t)alloc->elem_size * alloc->count);
+  pool_chunk_t* chunk = (pool_chunk_t*)mem;
+  chunk->prev = alloc->chunk;
+
+  alloc->chunk  = chunk;
+  alloc->data   = (u8*)mem + POOL_CHUNK_HEADER_SIZE;
+  alloc->used   = 0;
+  alloc->chunk_count++;
+  return true;
+}
+
+// @DOC: initializes pool_allocator for count elements of elem_size bytes
+//       ! needs to be free'd using pool_destroy()
+//       example:
+//        pool_alloc_t pool = {0};
+//        pool_init(&pool, sizeof(entity_t), 1024);
+//        entity_t* e = pool_alloc(&pool);
+//        pool_free(&pool, e);
+#define pool_init(_alloc, _elem_size, _count) pool_init_dbg(_alloc, _elem_size, _count, __FILE__, __LINE__)
+INLINE void pool_init_dbg(pool_alloc_t* alloc, u32 elem_size, u32 count, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->data == NULL, "alloc->data isnt null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(elem_size > 0,       "elem_size needs to be bigger than 0\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(count > 0,           "count needs to be bigger than 0\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  // free'd elements store the free list pointer
+  if (elem_size < sizeof(void*)) { elem_size = sizeof(void*); }
+  alloc->elem_size   = (u32)((elem_size + POOL_ALLOC_ALIGN -1) & ~(POOL_ALLOC_ALIGN -1));
+  alloc->count       = count;
+  alloc->used        = 0;
+  alloc->free_list   = NULL;
+  alloc->alloc_count = 0;
+  alloc->growable    = false;
+  alloc->max_chunks  = 1;
+  alloc->chunk_count = 0;
+  alloc->chunk       = NULL;
+  pool_add_chunk(alloc);
+}
+
+// @DOC: initializes pool_allocator in growable mode,
+//       instead of running out of memory new chunks of count elements get chained on
+//       max_chunks: cap for amount of chunks, 0 for no cap
+//       ! needs to be free'd using pool_destroy()
+#define pool_init_growable(_alloc, _elem_size, _count, _max_chunks) pool_init_growable_dbg(_alloc, _elem_size, _count, _max_chunks, __FILE__, __LINE__)
+INLINE void pool_init_growable_dbg(pool_alloc_t* alloc, u32 elem_size, u32 count, u32 max_chunks, const char* _file, const int _line)
+{
+  TRACE();
+
+  pool_init_dbg(alloc, elem_size, count, _file, _line);
+  alloc->growable   = true;
+  alloc->max_chunks = max_chunks;
+}
+
+// @DOC: returns pointer to a free element in the pool
+//       reuses the last pool_free()'d element first
+//       ! need to call pool_init() first
+#define pool_alloc(_alloc) pool_alloc_dbg(_alloc, __FILE__, __LINE__)
+INLINE void* pool_alloc_dbg(pool_alloc_t* alloc, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->data != NULL, "alloc->data is null pointer, call pool_init() first\n\t->file. %s, line: %d\n", _file, _line);
+
+  if (alloc->free_list != NULL)
+  {
+    void* ptr = alloc->free_list;
+    alloc->free_list = *(void**)ptr;
+    alloc->alloc_count++;
+    return ptr;
+  }
+  if (alloc->used < alloc->count || (alloc->growable && pool_add_chunk(alloc)))
+  {
+    void* ptr = &alloc->data[(size_t)alloc->used * alloc->elem_size];
+    alloc->used++;
+    alloc->alloc_count++;
+    return ptr;
+  }
+  ERR("pool_alloc ran out of memory\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+  return NULL;
+}
+
+#ifdef GLOBAL_DEBUG
+// @DOC: check if ptr points to the start of an element in one of the pools chunks
+INLINE bool pool_owns(pool_alloc_t* alloc, void* ptr)
+{
+  for (pool_chunk_t* c = alloc->chunk; c != NULL; c = c->prev)
+  {
+    u8* data = (u8*)c + POOL_CHUNK_HEADER_SIZE;
+    if ((u8*)ptr >= data && (u8*)ptr < data + (size_t)alloc->elem_size * alloc->count)
+    { return ((size_t)((u8*)ptr - data) % alloc->elem_size) == 0; }
+  }
+  return false;
+}
+#endif // GLOBAL_DEBUG
+
+// @DOC: give element back to the pool, to be reused by next pool_alloc()
+//       ! ptr is invalid afterwards
+#define pool_free(_alloc, _ptr) pool_free_dbg(_alloc, _ptr, __FILE__, __LINE__)
+INLINE void pool_free_dbg(pool_alloc_t* alloc, void* ptr, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,          "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(ptr != NULL,            "ptr is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->alloc_count > 0, "pool has no allocated elements, double free?\n\t->file. %s, line: %d\n", _file, _line);
+#ifdef GLOBAL_DEBUG
+  ERR_CHECK(pool_owns(alloc, ptr),  "ptr isnt an element of this pool\n\t->file. %s, line: %d\n", _file, _line);
+#endif
+  (void)_file; (void)_line;
+
+  *(void**)ptr     = alloc->free_list;
+  alloc->free_list = ptr;
+  alloc->alloc_count--;
+}
+
+// @DOC: give all elements back to the pool
+//       ! doesnt free, all pointers from pool_alloc() are invalid afterwards
+//       in growable mode keeps one chunk and frees the rest
+#define pool_reset(_alloc) pool_reset_dbg(_alloc, __FILE__, __LINE__)
+INLINE void pool_reset_dbg(pool_alloc_t* alloc, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->data != NULL, "alloc->data is null pointer, call pool_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  pool_chunk_t* c = alloc->chunk->prev;
+  while (c != NULL)
+  {
+    pool_chunk_t* prev = c->prev;
+    FREE(c);
+    c = prev;
+  }
+  alloc->chunk->prev = NULL;
+  alloc->chunk_count = 1;
+  alloc->used        = 0;
+  alloc->free_list   = NULL;
+  alloc->alloc_count = 0;
+}
+
+// @DOC: frees memory allocated in pool_init()
+//       ! after calling this need to call pool_init(),
+//         before calling pool_alloc() again
+#define pool_destroy(_alloc) pool_destroy_dbg(_alloc, __FILE__, __LINE__)
+INLINE void pool_destroy_dbg(pool_alloc_t* alloc, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(alloc != NULL,       "alloc is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(alloc->data != NULL, "alloc->data is null pointer, call pool_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  pool_chunk_t* c = alloc->chunk;
+  while (c != NULL)
+  {
+    pool_chunk_t* prev = c->prev;
+    FREE(c);
+    c = prev;
+  }
+  alloc->chunk       = NULL;
+  alloc->data        = NULL;
+  alloc->used        = 0;
+  alloc->free_list   = NULL;
+  alloc->alloc_count = 0;
+  alloc->chunk_count = 0;
+}
+
+// @DOC: typed helpers
+//       pool_alloc_t pool = {0};
+//       POOL_INIT_TYPE(&pool, entity_t, 1024);
+//       entity_t* e = POOL_ALLOC_TYPE(&pool, entity_t);
+#define POOL_INIT_TYPE(_alloc, _type, _count)   pool_init((_alloc), (u32)sizeof(_type), (_count))
+#define POOL_ALLOC_TYPE(_alloc, _type)          ((_type*)pool_alloc(_alloc))
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif  // GLOBAL_POOL_ALLOC_H
@@ -0,0 +1,193 @@
+#ifndef GLOBAL_STR_BUILDER_H
+#define GLOBAL_STR_BUILDER_H
+
+
+
+#include "global.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: string builder, appends into one contiguous buffer that grows by doubling
+//       either in a bump_alloc_t arena or in malloc'd memory
+//       in an arena the buffer grows in place as long as nothing else got allocated after it,
+//       otherwise it gets moved to the top of the arena, the old buffer stays in the arena until bump_reset()
+//       example:
+//        str_builder_t sb;
+//        str_builder_init(&sb, &arena, 256);  // NULL instead of &arena for malloc
+//        str_builder_append_cstr(&sb, "x: ");
+//        str_builder_append_s64(&sb, x);
+//        str_builder_appendf(&sb, ", %s\n", name);
+//        str_view_t str = str_builder_finish(&sb); // str.ptr is '\0' terminated
+typedef struct
+{
+  bump_alloc_t* alloc;        // NULL for malloc
+  char*         data;
+  u64           len;
+  u64           cap;
+}str_builder_t;
+
+// @DOC: initializes builder with room for cap chars
+//       alloc: arena to allocate from, NULL for malloc, then needs to be free'd using str_builder_free()
+#define str_builder_init(_sb, _alloc, _cap) str_builder_init_dbg(_sb, _alloc, _cap, __FILE__, __LINE__)
+INLINE void str_builder_init_dbg(str_builder_t* sb, bump_alloc_t* alloc, u64 cap, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(sb != NULL, "sb is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  if (cap < 16) { cap = 16; }
+  sb->alloc = alloc;
+  sb->len   = 0;
+  sb->cap   = cap;
+  if (alloc != NULL) { sb->data = (char*)bump_alloc_aligned_dbg(alloc, cap, 1, _file, _line); }
+  else
+  {
+    void* mem = NULL;
+    MALLOC(mem, cap);
+    sb->data = (char*)mem;
+  }
+}
+
+// @DOC: make room for n more chars, at least doubles the buffer so appending is amortized O(1)
+//       ! pointers into the builder arent valid after this
+#define str_builder_reserve(_sb, _n) str_builder_reserve_dbg(_sb, _n, __FILE__, __LINE__)
+INLINE void str_builder_reserve_dbg(str_builder_t* sb, u64 n, const char* _file, const int _line)
+{
+  ERR_CHECK(sb != NULL && sb->data != NULL, "sb isnt initialized, call str_builder_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  if (sb->len + n <= sb->cap) { return; }
+  u64 cap = sb->cap * 2;
+  if (cap < sb->len + n) { cap = sb->len + n; }
+
+  if (sb->alloc == NULL)
+  {
+    void* mem = sb->data;
+    REALLOC(mem, cap);
+    sb->data = (char*)mem;
+    sb->cap  = cap;
+    return;
+  }
+  bump_alloc_t* alloc = sb->alloc;
+  // buffer is the last allocation and there is room behind it, extend it
+  if (bump_resize_last_dbg(alloc, sb->data, cap, _file, _line))
+  {
+    sb->cap = cap;
+    return;
+  }
+  char* data = (char*)bump_alloc_aligned_dbg(alloc, cap, 1, _file, _line);
+  memcpy(data, sb->data, sb->len);
+  sb->data = data;
+  sb->cap  = cap;
+}
+
+#define str_builder_append(_sb, _str, _len) str_builder_append_dbg(_sb, _str, _len, __FILE__, __LINE__)
+INLINE void str_builder_append_dbg(str_builder_t* sb, const char* str, u64 len, const char* _file, const int _line)
+{
+  str_builder_reserve_dbg(sb, len, _file, _line);
+  if (len > 0) { memcpy(sb->data + sb->len, str, len); }
+  sb->len += len;
+}
+#define str_builder_append_cstr(_sb, _str)  str_builder_append_dbg(_sb, _str, strlen(_str), __FILE__, __LINE__)
+#define str_builder_append_view(_sb, _view) str_builder_append_dbg(_sb, (_view).ptr, (_view).len, __FILE__, __LINE__)
+
+#define str_builder_append_char(_sb, _c) str_builder_append_char_dbg(_sb, _c, __FILE__, __LINE__)
+INLINE void str_builder_append_char_dbg(str_builder_t* sb, char c, const char* _file, const int _line)
+{
+  str_builder_reserve_dbg(sb, 1, _file, _line);
+  sb->data[sb->len++] = c;
+}
+
+// @DOC: numbers get formatted straight into the buffer, see pf_fmt_u64(), etc. in global_print.h
+//       floats are the shortest text that reads back as the same value
+#define __STR_BUILDER_APPEND_FMT(_sb, _fmt, ...)                                              \
+  {                                                                                           \
+    str_builder_reserve_dbg(_sb, PF_FMT_MAX, _file, _line);                                   \
+    (_sb)->len += _fmt((_sb)->data + (_sb)->len, __VA_ARGS__);                                \
+  }
+#define str_builder_append_u64(_sb, _v)             str_builder_append_u64_dbg(_sb, _v, __FILE__, __LINE__)
+INLINE void str_builder_append_u64_dbg(str_builder_t* sb, u64 v, const char* _file, const int _line)
+{ __STR_BUILDER_APPEND_FMT(sb, pf_fmt_u64, v); }
+#define str_builder_append_s64(_sb, _v)             str_builder_append_s64_dbg(_sb, _v, __FILE__, __LINE__)
+INLINE void str_builder_append_s64_dbg(str_builder_t* sb, s64 v, const char* _file, const int _line)
+{ __STR_BUILDER_APPEND_FMT(sb, pf_fmt_s64, v); }
+#define str_builder_append_f64(_sb, _v)             str_builder_append_f64_dbg(_sb, _v, __FILE__, __LINE__)
+INLINE void str_builder_append_f64_dbg(str_builder_t* sb, f64 v, const char* _file, const int _line)
+{ __STR_BUILDER_APPEND_FMT(sb, pf_fmt_f64, v); }
+#define str_builder_append_f32(_sb, _v)             str_builder_append_f32_dbg(_sb, _v, __FILE__, __LINE__)
+INLINE void str_builder_append_f32_dbg(str_builder_t* sb, f32 v, const char* _file, const int _line)
+{ __STR_BUILDER_APPEND_FMT(sb, pf_fmt_f32, v); }
+// @DOC: lowercase hex without 0x, at least min_digits
+#define str_builder_append_hex(_sb, _v, _min_digits) str_builder_append_hex_dbg(_sb, _v, _min_digits, __FILE__, __LINE__)
+INLINE void str_builder_append_hex_dbg(str_builder_t* sb, u64 v, u32 min_digits, const char* _file, const int _line)
+{ __STR_BUILDER_APPEND_FMT(sb, pf_fmt_hex, v, min_digits); }
+#undef __STR_BUILDER_APPEND_FMT
+
+// @DOC: printf into the builder, formats straight into the buffer, only formats twice if it didnt fit
+//       not INLINE, functions with ... cant be forced inline
+#define str_builder_appendf(_sb, ...) str_builder_appendf_dbg(_sb, __FILE__, __LINE__, __VA_ARGS__)
+#if defined(__GNUC__) || defined(__clang__)
+  __attribute__((format(printf, 4, 5)))
+#endif
+static inline void str_builder_appendf_dbg(str_builder_t* sb, const char* _file, const int _line, const char* fmt, ...)
+{
+  str_builder_reserve_dbg(sb, 1, _file, _line);
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(sb->data + sb->len, (size_t)(sb->cap - sb->len), fmt, args);
+  va_end(args);
+  ERR_CHECK(n >= 0, "vsnprintf failed for format: %s\n\t->file. %s, line: %d\n", fmt, _file, _line);
+  if (sb->len + (u64)n >= sb->cap)
+  {
+    str_builder_reserve_dbg(sb, (u64)n +1, _file, _line);
+    va_start(args, fmt);
+    vsnprintf(sb->data + sb->len, (size_t)(sb->cap - sb->len), fmt, args);
+    va_end(args);
+  }
+  sb->len += (u64)n;
+}
+
+// @DOC: '\0' terminates and returns the string, without the '\0' in len
+//       in an arena the unused rest of the buffer goes back to the arena, if nothing got allocated after it
+//       ! dont append after this, call str_builder_init() again for a new string
+#define str_builder_finish(_sb) str_builder_finish_dbg(_sb, __FILE__, __LINE__)
+INLINE str_view_t str_builder_finish_dbg(str_builder_t* sb, const char* _file, const int _line)
+{
+  str_builder_reserve_dbg(sb, 1, _file, _line);
+  sb->data[sb->len] = '\0';
+  if (sb->alloc != NULL && bump_resize_last_dbg(sb->alloc, sb->data, sb->len +1, _file, _line))
+  { sb->cap = sb->len +1; }
+  return str_view(sb->data, sb->len);
+}
+
+// @DOC: empty the builder, keeps the buffer
+INLINE void str_builder_clear(str_builder_t* sb)
+{
+  sb->len = 0;
+}
+
+// @DOC: frees buffer of builder without arena, does nothing for arena builders, their memory goes with bump_reset()
+#define str_builder_free(_sb) str_builder_free_dbg(_sb, __FILE__, __LINE__)
+INLINE void str_builder_free_dbg(str_builder_t* sb, const char* _file, const int _line)
+{
+  ERR_CHECK(sb != NULL && sb->data != NULL, "sb isnt initialized, call str_builder_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  if (sb->alloc == NULL) { FREE(sb->data); }
+  sb->data = NULL;
+  sb->len  = 0;
+  sb->cap  = 0;
+}
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif  // GLOBAL_STR_BUILDER_H
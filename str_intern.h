@@ -0,0 +1,211 @@
+#ifndef GLOBAL_STR_INTERN_H
+#define GLOBAL_STR_INTERN_H
+
+
+
+#include "global.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// @DOC: string interning, every distinct string gets stored once and gets a u32 id
+//       comparing two interned strings is comparing their ids, no strcmp()
+//       ids are consecutive starting at 0, so they can index arrays
+//       the strings live in a growable bump_alloc_t owned by the table, pointers stay valid until str_intern_free()
+//       ! not thread safe
+//       example:
+//        str_intern_t in;
+//        str_intern_init(&in, 64);
+//        u32 a = str_intern_cstr(&in, __FILE__);
+//        u32 b = str_intern(&in, buf, len);
+//        if (a == b) { ... }
+//        P_STR(str_intern_cstr_get(&in, a));
+//        str_intern_free(&in);
+
+// @DOC: returned by str_intern_find() if the string isnt interned
+#define STR_INTERN_NONE  ((u32)-1)
+
+// @DOC: size of the arenas first block, later blocks grow, see bump_init_growable()
+#ifndef STR_INTERN_ARENA_SIZE
+#define STR_INTERN_ARENA_SIZE 4096
+#endif
+
+typedef struct
+{
+  const char* ptr;            // '\0' terminated, in arena
+  u32         len;
+  u32         hash;
+}str_intern_entry_t;
+
+typedef struct
+{
+  bump_alloc_t        arena;        // string bytes
+  str_intern_entry_t* entries;      // indexed by id
+  u32                 count;
+  u32                 entries_cap;
+  u32*                table;        // open addressing, stores id +1, 0 is empty
+  u32                 table_size;   // power of 2
+}str_intern_t;
+
+// @DOC: hash of len bytes of str, 8 bytes at a time
+INLINE u32 str_intern_hash(const char* str, u64 len)
+{
+  u64 h = 0x9E3779B97F4A7C15ull ^ (len * 0xFF51AFD7ED558CCDull);
+  u64 i = 0;
+  for (; i + 8 <= len; i += 8)
+  {
+    u64 w;
+    memcpy(&w, str + i, 8);
+    h = (h ^ w) * 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 29;
+  }
+  u64 w = 0;
+  if (i < len) { memcpy(&w, str + i, (size_t)(len - i)); }
+  h = (h ^ w) * 0xC4CEB9FE1A85EC53ull;
+  h ^= h >> 32;
+  return (u32)h;
+}
+
+// @DOC: initializes table with room for about cap strings before it grows
+//       ! needs to be free'd using str_intern_free()
+#define str_intern_init(_in, _cap) str_intern_init_dbg(_in, _cap, __FILE__, __LINE__)
+INLINE void str_intern_init_dbg(str_intern_t* in, u32 cap, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(in != NULL, "in is null pointer\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  if (cap < 16) { cap = 16; }
+  in->arena.data = NULL;
+  bump_init_growable_dbg(&in->arena, STR_INTERN_ARENA_SIZE, 0, _file, _line);
+
+  in->count       = 0;
+  in->entries_cap = cap;
+  void* mem = NULL;
+  MALLOC(mem, sizeof(str_intern_entry_t) * cap);
+  in->entries = (str_intern_entry_t*)mem;
+
+  // keep load below 3/4
+  in->table_size = 1;
+  while (in->table_size * 3 < cap * 4) { in->table_size *= 2; }
+  in->table = (u32*)calloc(in->table_size, sizeof(u32));
+  ERR_CHECK(in->table != NULL, "failed to allocate %u table slots\n\t->file. %s, line: %d\n", in->table_size, _file, _line);
+}
+
+// @DOC: slot of str in table, either holding its id +1 or empty
+INLINE u32* __str_intern_slot(str_intern_t* in, const char* str, u32 len, u32 hash)
+{
+  u32 mask = in->table_size -1;
+  for (u32 i = hash & mask; ; i = (i + 1) & mask)
+  {
+    u32* slot = &in->table[i];
+    if (*slot == 0) { return slot; }
+    str_intern_entry_t* e = &in->entries[*slot -1];
+    if (e->hash == hash && e->len == len && memcmp(e->ptr, str, len) == 0) { return slot; }
+  }
+}
+
+// @DOC: double table size and reinsert all ids, uses the stored hashes
+INLINE void __str_intern_grow_table(str_intern_t* in, const char* _file, const int _line)
+{
+  (void)_file; (void)_line;
+  FREE(in->table);
+  in->table_size *= 2;
+  in->table = (u32*)calloc(in->table_size, sizeof(u32));
+  ERR_CHECK(in->table != NULL, "failed to allocate %u table slots\n\t->file. %s, line: %d\n", in->table_size, _file, _line);
+
+  u32 mask = in->table_size -1;
+  for (u32 id = 0; id < in->count; ++id)
+  {
+    u32 i = in->entries[id].hash & mask;
+    while (in->table[i] != 0) { i = (i + 1) & mask; }
+    in->table[i] = id + 1;
+  }
+}
+
+// @DOC: id of str, adds a copy of it if it isnt interned yet
+//       str doesnt need to be '\0' terminated
+#define str_intern(_in, _str, _len) str_intern_dbg(_in, _str, _len, __FILE__, __LINE__)
+INLINE u32 str_intern_dbg(str_intern_t* in, const char* str, u64 len, const char* _file, const int _line)
+{
+  ERR_CHECK(in != NULL && in->table != NULL, "in isnt initialized, call str_intern_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  ERR_CHECK(len < (u32)-1, "str is too long to intern: %" PRIu64 "\n\t->file. %s, line: %d\n", len, _file, _line);
+  (void)_file; (void)_line;
+
+  u32  hash = str_intern_hash(str, len);
+  u32* slot = __str_intern_slot(in, str, (u32)len, hash);
+  if (*slot != 0) { return *slot -1; }
+
+  if (in->count == in->entries_cap)
+  {
+    in->entries_cap *= 2;
+    void* mem = in->entries;
+    REALLOC(mem, sizeof(str_intern_entry_t) * in->entries_cap);
+    in->entries = (str_intern_entry_t*)mem;
+  }
+  char* copy = (char*)bump_alloc_aligned_dbg(&in->arena, len + 1, 1, _file, _line);
+  if (len > 0) { memcpy(copy, str, len); }
+  copy[len] = '\0';
+
+  u32 id = in->count++;
+  in->entries[id].ptr  = copy;
+  in->entries[id].len  = (u32)len;
+  in->entries[id].hash = hash;
+  *slot = id + 1;
+
+  if (in->count * 4 > in->table_size * 3) { __str_intern_grow_table(in, _file, _line); }
+  return id;
+}
+#define str_intern_cstr(_in, _str)  str_intern_dbg(_in, _str, strlen(_str), __FILE__, __LINE__)
+#define str_intern_view(_in, _view) str_intern_dbg(_in, (_view).ptr, (_view).len, __FILE__, __LINE__)
+
+// @DOC: id of str or STR_INTERN_NONE, doesnt add it
+#define str_intern_find(_in, _str, _len) str_intern_find_dbg(_in, _str, _len, __FILE__, __LINE__)
+INLINE u32 str_intern_find_dbg(str_intern_t* in, const char* str, u64 len, const char* _file, const int _line)
+{
+  ERR_CHECK(in != NULL && in->table != NULL, "in isnt initialized, call str_intern_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  if (len >= (u32)-1) { return STR_INTERN_NONE; }
+  u32* slot = __str_intern_slot(in, str, (u32)len, str_intern_hash(str, len));
+  return *slot != 0 ? *slot -1 : STR_INTERN_NONE;
+}
+
+// @DOC: interned string of id, ptr is '\0' terminated and stays valid until str_intern_free()
+#define str_intern_get(_in, _id) str_intern_get_dbg(_in, _id, __FILE__, __LINE__)
+INLINE str_view_t str_intern_get_dbg(str_intern_t* in, u32 id, const char* _file, const int _line)
+{
+  ERR_CHECK(in != NULL && id < in->count, "id %u isnt interned\n\t->file. %s, line: %d\n", id, _file, _line);
+  (void)_file; (void)_line;
+  return str_view(in->entries[id].ptr, in->entries[id].len);
+}
+#define str_intern_cstr_get(_in, _id) (str_intern_get(_in, _id).ptr)
+
+// @DOC: frees all strings, table and entries
+//       ! after calling this need to call str_intern_init() again
+#define str_intern_free(_in) str_intern_free_dbg(_in, __FILE__, __LINE__)
+INLINE void str_intern_free_dbg(str_intern_t* in, const char* _file, const int _line)
+{
+  TRACE();
+
+  ERR_CHECK(in != NULL && in->table != NULL, "in isnt initialized, call str_intern_init() first\n\t->file. %s, line: %d\n", _file, _line);
+  (void)_file; (void)_line;
+
+  bump_free_dbg(&in->arena, _file, _line);
+  FREE(in->entries);
+  FREE(in->table);
+  in->count       = 0;
+  in->entries_cap = 0;
+  in->table_size  = 0;
+}
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif  // GLOBAL_STR_INTERN_H
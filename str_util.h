@@ -12,6 +12,16 @@
 #include <string.h>
 #include <math.h>   // abs()
 
+// @DOC: sse2 is always there on x64, avx2 only with -mavx2 / /arch:AVX2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define STR_UTIL_SSE2
+  #include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+  #define STR_UTIL_AVX2
+  #include <immintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -19,6 +29,203 @@ extern "C"
 
 // @DOC: find last occurance of str
 char* str_util_find_last_of(char* str, char* identifier);
+// @DOC: find last occurance of identifier in the first len chars of str, NULL if none
+//       scans backwards, returns at the first match from the end
+//       str doesnt need to be '\0' terminated, empty identifier never matches
+const char* str_util_find_last_of_len(const char* str, u64 len, const char* identifier, u64 identifier_len);
+
+// -- str view --
+
+// @DOC: string that knows its length, points into someone elses memory, not '\0' terminated
+//       nothing here allocates or copies, slices point into the same memory
+//       str_view_t v = str_view_cstr(path);  // strlen once, then never again
+//       printf(STR_VIEW_FMT "\n", STR_VIEW_ARG(v));
+typedef struct
+{
+  const char* ptr;
+  u64         len;
+}str_view_t;
+
+// @DOC: returned by find functions if nothing was found
+#define STR_VIEW_NPOS         ((u64)-1)
+// @DOC: view of string literal, without strlen
+#define STR_VIEW_LIT(_lit)    str_view((_lit), sizeof(_lit) -1)
+// @DOC: printf format & args for views
+#define STR_VIEW_FMT          "%.*s"
+#define STR_VIEW_ARG(_v)      (int)(_v).len, (_v).ptr
+
+INLINE str_view_t str_view(const char* ptr, u64 len)
+{
+  str_view_t v = { ptr, len };
+  return v;
+}
+INLINE str_view_t str_view_cstr(const char* str)
+{
+  return str_view(str, str == NULL ? 0 : strlen(str));
+}
+
+// @DOC: chars [start, end) of v, both get clamped to v.len
+INLINE str_view_t str_view_slice(str_view_t v, u64 start, u64 end)
+{
+  if (end   > v.len) { end   = v.len; }
+  if (start > end)   { start = end; }
+  return str_view(v.ptr + start, end - start);
+}
+
+INLINE bool str_view_equal(str_view_t a, str_view_t b)
+{
+  return a.len == b.len && (a.len == 0 || memcmp(a.ptr, b.ptr, a.len) == 0);
+}
+// @DOC: < 0 if a sorts before b, 0 if equal, > 0 after, same as strcmp()
+INLINE s32 str_view_compare(str_view_t a, str_view_t b)
+{
+  u64 len = a.len < b.len ? a.len : b.len;
+  s32 cmp = len == 0 ? 0 : memcmp(a.ptr, b.ptr, len);
+  if (cmp != 0)      { return cmp; }
+  return a.len < b.len ? -1 : a.len > b.len ? 1 : 0;
+}
+
+INLINE bool str_view_starts_with(str_view_t v, str_view_t prefix)
+{
+  return prefix.len <= v.len && (prefix.len == 0 || memcmp(v.ptr, prefix.ptr, prefix.len) == 0);
+}
+INLINE bool str_view_ends_with(str_view_t v, str_view_t suffix)
+{
+  return suffix.len <= v.len && (suffix.len == 0 || memcmp(v.ptr + v.len - suffix.len, suffix.ptr, suffix.len) == 0);
+}
+
+// @DOC: index of first / last c in v, STR_VIEW_NPOS if none
+INLINE u64 str_view_find_char(str_view_t v, char c)
+{
+  const char* hit = v.len == 0 ? NULL : (const char*)memchr(v.ptr, c, v.len);
+  return hit == NULL ? STR_VIEW_NPOS : (u64)(hit - v.ptr);
+}
+INLINE u64 str_view_rfind_char(str_view_t v, char c)
+{
+  for (u64 i = v.len; i > 0; --i)
+  { if (v.ptr[i -1] == c) { return i -1; } }
+  return STR_VIEW_NPOS;
+}
+
+// @DOC: index of first / last needle in v, STR_VIEW_NPOS if none, empty needle is found at 0 / v.len
+INLINE u64 str_view_find(str_view_t v, str_view_t needle)
+{
+  if (needle.len == 0)    { return 0; }
+  if (needle.len > v.len) { return STR_VIEW_NPOS; }
+  const char* p   = v.ptr;
+  const char* end = v.ptr + v.len - needle.len +1;   // last possible start +1
+  while ((p = (const char*)memchr(p, needle.ptr[0], (size_t)(end - p))) != NULL)
+  {
+    if (memcmp(p +1, needle.ptr +1, needle.len -1) == 0) { return (u64)(p - v.ptr); }
+    p++;
+  }
+  return STR_VIEW_NPOS;
+}
+INLINE u64 str_view_rfind(str_view_t v, str_view_t needle)
+{
+  if (needle.len == 0) { return v.len; }
+  const char* hit = str_util_find_last_of_len(v.ptr, v.len, needle.ptr, needle.len);
+  return hit == NULL ? STR_VIEW_NPOS : (u64)(hit - v.ptr);
+}
+
+// @DOC: remove ' ', '\t', '\n', '\r', '\v', '\f' from start / end / both
+INLINE bool __str_view_is_space(char c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+INLINE str_view_t str_view_trim_left(str_view_t v)
+{
+  while (v.len > 0 && __str_view_is_space(v.ptr[0])) { v.ptr++; v.len--; }
+  return v;
+}
+INLINE str_view_t str_view_trim_right(str_view_t v)
+{
+  while (v.len > 0 && __str_view_is_space(v.ptr[v.len -1])) { v.len--; }
+  return v;
+}
+INLINE str_view_t str_view_trim(str_view_t v)
+{
+  return str_view_trim_right(str_view_trim_left(v));
+}
+
+// @DOC: take the part up to the next sep out of rest, false once rest is used up
+//       "a,b,,c" -> "a", "b", "", "c"
+//       str_view_t rest = str_view_cstr(line), part;
+//       while (str_view_split(&rest, ',', &part)) { ... }
+INLINE bool str_view_split(str_view_t* rest, char sep, str_view_t* part)
+{
+  if (rest->ptr == NULL) { return false; }
+  u64 i = str_view_find_char(*rest, sep);
+  if (i == STR_VIEW_NPOS)
+  {
+    *part = *rest;
+    *rest = str_view(NULL, 0);   // marks rest as used up, so a trailing empty part still gets returned
+    return true;
+  }
+  *part = str_view(rest->ptr, i);
+  *rest = str_view(rest->ptr + i +1, rest->len - i -1);
+  return true;
+}
+
+// -- tokenizer --
+
+// @DOC: splits input into tokens at any of up to STR_TOK_MAX_DELIMS delimiters, i.e. lines or fields
+//       delimiters get searched for 64 bytes at a time using sse2/avx2, scalar without
+//       input can come in chunks, i.e. fread() buffers, or all at once, i.e. mmap'd file
+//       tokens point into the chunk, only a token split across two chunks gets copied together
+//       text after the last delimiter is a token, an empty one isnt: "a\nb\n" -> "a", "b"
+//       str_tok_t tok; str_view_t line; u64 n;
+//       str_tok_init_lines(&tok);
+//       do
+//       {
+//         n = fread(buf, 1, sizeof(buf), f);
+//         str_tok_feed(&tok, buf, n, n == 0);   // last chunk can be empty
+//         while (str_tok_next(&tok, &line)) { ... }
+//       } while (n > 0);
+//       str_tok_free(&tok);
+#define STR_TOK_MAX_DELIMS  8
+
+typedef enum str_tok_flags
+{
+  STR_TOK_NONE        = 0,
+  STR_TOK_SKIP_EMPTY  = FLAG(0),   // no empty tokens between two delimiters
+  STR_TOK_STRIP_CR    = FLAG(1),   // cut '\r' at the end of tokens ending at '\n' or end of input, for "\r\n" lines
+}str_tok_flags;
+
+typedef struct
+{
+  char        delims[STR_TOK_MAX_DELIMS];
+  u32         delim_count;
+  u32         flags;          // str_tok_flags
+  bool        is_delim[256];
+
+  const char* chunk;          // current chunk, see str_tok_feed()
+  u64         len;
+  bool        last;           // no chunks after this one
+  u64         pos;            // start of next token in chunk
+  u64         block;          // start of 64 bytes bits is for
+  u64         bits;           // delimiters in block not returned yet, bit i is chunk[block + i]
+
+  char*       carry;          // start of token from previous chunks, malloc'd
+  u64         carry_len;
+  u64         carry_cap;
+  bool        carry_out;      // carry was returned, gets emptied on next call
+}str_tok_t;
+
+// @DOC: delims: '\0' terminated, each char is a delimiter
+//       flags:  str_tok_flags
+//       ! needs to be free'd using str_tok_free()
+void str_tok_init(str_tok_t* tok, const char* delims, u32 flags);
+// @DOC: split at '\n', without '\r' at the end of lines
+#define str_tok_init_lines(_tok) str_tok_init(_tok, "\n", STR_TOK_STRIP_CR)
+// @DOC: next chunk of input, previous chunk isnt used anymore after this
+//       last: true for the last chunk, only then text after the last delimiter gets returned
+void str_tok_feed(str_tok_t* tok, const char* chunk, u64 len, bool last);
+// @DOC: next token, false if chunk is used up and str_tok_feed() needs to be called
+//       token is valid until chunk memory is, or if it was split across chunks until next call
+bool str_tok_next(str_tok_t* tok, str_view_t* token);
+void str_tok_free(str_tok_t* tok);
+
 // @DOC: truncate str at pos
 char* str_util_trunc(char* str, int pos);
 
@@ -35,20 +242,234 @@ extern "C"
 #endif
 
 char* str_util_find_last_of(char* str, char* identifier)
+{
+  return (char*)str_util_find_last_of_len(str, strlen(str), identifier, strlen(identifier));
+}
+
+// @DOC: index of highest set bit, mask != 0
+static inline u32 __str_util_last_bit(u32 mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long i; _BitScanReverse(&i, mask); return (u32)i;
+#else
+  return 31 - (u32)__builtin_clz(mask);
+#endif
+}
+
+// @DOC: simd compares first and last char of identifier at 16/32 positions at once
+//       only positions where both match get compared fully, highest position first
+//       blocks go from the end to the start, the rest at the start is done scalar
+const char* str_util_find_last_of_len(const char* str, u64 len, const char* identifier, u64 identifier_len)
 {
   TRACE();
 
-    char* last = NULL;
-    size_t n = strlen(identifier);
-    while (*str)
+  u64 n = identifier_len;
+  if (n == 0 || n > len) { return NULL; }
+  const char first = identifier[0];
+  const char last  = identifier[n -1];
+  u64 end = len - n +1;   // positions [0, end) not checked yet
+
+#ifdef STR_UTIL_AVX2
+  const __m256i first_32 = _mm256_set1_epi8(first);
+  const __m256i last_32  = _mm256_set1_epi8(last);
+  while (end >= 32)
+  {
+    u64 b = end - 32;
+    __m256i a  = _mm256_loadu_si256((const __m256i*)(str + b));
+    __m256i z  = _mm256_loadu_si256((const __m256i*)(str + b + n -1));
+    u32 mask   = (u32)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first_32), _mm256_cmpeq_epi8(z, last_32)));
+    while (mask)
     {
-        // go through str and compare with identifier
-        if (!memcmp(str++, identifier, n))
-        {
-            last = str - 1;
-        }
+      u32 bit = __str_util_last_bit(mask);
+      if (n <= 2 || memcmp(str + b + bit +1, identifier +1, n -2) == 0) { return str + b + bit; }
+      mask &= ~(1u << bit);
     }
-    return last;
+    end = b;
+  }
+#endif
+#ifdef STR_UTIL_SSE2
+  const __m128i first_16 = _mm_set1_epi8(first);
+  const __m128i last_16  = _mm_set1_epi8(last);
+  while (end >= 16)
+  {
+    u64 b = end - 16;
+    __m128i a  = _mm_loadu_si128((const __m128i*)(str + b));
+    __m128i z  = _mm_loadu_si128((const __m128i*)(str + b + n -1));
+    u32 mask   = (u32)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first_16), _mm_cmpeq_epi8(z, last_16)));
+    while (mask)
+    {
+      u32 bit = __str_util_last_bit(mask);
+      if (n <= 2 || memcmp(str + b + bit +1, identifier +1, n -2) == 0) { return str + b + bit; }
+      mask &= ~(1u << bit);
+    }
+    end = b;
+  }
+#endif
+
+  // scalar, also the fallback without simd
+  while (end > 0)
+  {
+    end--;
+    if (str[end] == first && str[end + n -1] == last && 
+        (n <= 2 || memcmp(str + end +1, identifier +1, n -2) == 0)) 
+    { return str + end; }
+  }
+  return NULL;
+}
+
+void str_tok_init(str_tok_t* tok, const char* delims, u32 flags)
+{
+  TRACE();
+
+  u32 count = (u32)strlen(delims);
+  ERR_CHECK(count > 0 && count <= STR_TOK_MAX_DELIMS, "need 1 to %d delimiters, got %u\n", STR_TOK_MAX_DELIMS, count);
+
+  memset(tok, 0, sizeof(str_tok_t));
+  memcpy(tok->delims, delims, count);
+  tok->delim_count = count;
+  tok->flags       = flags;
+  for (u32 i = 0; i < count; ++i) { tok->is_delim[(u8)delims[i]] = true; }
+  str_tok_feed(tok, NULL, 0, false);
+}
+
+void str_tok_feed(str_tok_t* tok, const char* chunk, u64 len, bool last)
+{
+  tok->chunk = chunk;
+  tok->len   = len;
+  tok->last  = last;
+  tok->pos   = 0;
+  tok->block = (u64)-64;    // first block gets loaded on first search
+  tok->bits  = 0;
+}
+
+// @DOC: index of lowest set bit, mask != 0
+static inline u32 __str_util_first_bit(u64 mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long i; _BitScanForward64(&i, mask); return (u32)i;
+#else
+  return (u32)__builtin_ctzll(mask);
+#endif
+}
+
+// @DOC: bit i is set if p[i] is a delimiter, for n <= 64 bytes
+//       full 64 bytes get compared against every delimiter using simd, the tail of a chunk scalar
+static inline u64 __str_tok_block_mask(const str_tok_t* tok, const char* p, u64 n)
+{
+  u64 mask = 0;
+#if defined(STR_UTIL_AVX2)
+  if (n == 64)
+  {
+    __m256i a = _mm256_loadu_si256((const __m256i*)p);
+    __m256i b = _mm256_loadu_si256((const __m256i*)(p + 32));
+    __m256i match_a = _mm256_setzero_si256();
+    __m256i match_b = _mm256_setzero_si256();
+    for (u32 d = 0; d < tok->delim_count; ++d)
+    {
+      __m256i delim = _mm256_set1_epi8(tok->delims[d]);
+      match_a = _mm256_or_si256(match_a, _mm256_cmpeq_epi8(a, delim));
+      match_b = _mm256_or_si256(match_b, _mm256_cmpeq_epi8(b, delim));
+    }
+    return (u64)(u32)_mm256_movemask_epi8(match_a) | ((u64)(u32)_mm256_movemask_epi8(match_b) << 32);
+  }
+#elif defined(STR_UTIL_SSE2)
+  if (n == 64)
+  {
+    for (u32 q = 0; q < 4; ++q)
+    {
+      __m128i v     = _mm_loadu_si128((const __m128i*)(p + q * 16));
+      __m128i match = _mm_setzero_si128();
+      for (u32 d = 0; d < tok->delim_count; ++d)
+      { match = _mm_or_si128(match, _mm_cmpeq_epi8(v, _mm_set1_epi8(tok->delims[d]))); }
+      mask |= (u64)(u32)_mm_movemask_epi8(match) << (q * 16);
+    }
+    return mask;
+  }
+#endif
+  // scalar, also the fallback without simd
+  for (u64 i = 0; i < n; ++i)
+  {
+    if (tok->is_delim[(u8)p[i]]) { mask |= 1ull << i; }
+  }
+  return mask;
+}
+
+// @DOC: index of next delimiter in chunk and marks it as used, len if there is none
+static inline u64 __str_tok_find(str_tok_t* tok)
+{
+  while (tok->bits == 0)
+  {
+    if (tok->block + 64 >= tok->len) { return tok->len; }
+    tok->block += 64;
+    u64 n = tok->len - tok->block;
+    tok->bits = __str_tok_block_mask(tok, tok->chunk + tok->block, n < 64 ? n : 64);
+  }
+  u64 i = tok->block + __str_util_first_bit(tok->bits);
+  tok->bits &= tok->bits -1;
+  return i;
+}
+
+static inline void __str_tok_carry(str_tok_t* tok, const char* str, u64 len)
+{
+  if (len == 0) { return; }
+  if (tok->carry_len + len > tok->carry_cap)
+  {
+    u64 cap = tok->carry_cap * 2;
+    if (cap < tok->carry_len + len) { cap = tok->carry_len + len; }
+    if (cap < 64)                   { cap = 64; }
+    void* mem = tok->carry;
+    REALLOC(mem, cap);
+    tok->carry     = (char*)mem;
+    tok->carry_cap = cap;
+  }
+  memcpy(tok->carry + tok->carry_len, str, len);
+  tok->carry_len += len;
+}
+
+bool str_tok_next(str_tok_t* tok, str_view_t* token)
+{
+  if (tok->carry_out) { tok->carry_len = 0; tok->carry_out = false; }
+
+  while (true)
+  {
+    u64 end = __str_tok_find(tok);
+    if (end == tok->len && !tok->last)
+    {
+      // token continues in next chunk
+      if (tok->pos < tok->len) { __str_tok_carry(tok, tok->chunk + tok->pos, tok->len - tok->pos); }
+      tok->pos = tok->len;
+      return false;
+    }
+    if (end == tok->len && tok->pos == tok->len && tok->carry_len == 0) { return false; }
+
+    str_view_t t;
+    if (tok->carry_len > 0)
+    {
+      __str_tok_carry(tok, tok->chunk + tok->pos, end - tok->pos);
+      t = str_view(tok->carry, tok->carry_len);
+      tok->carry_out = true;
+    }
+    else { t = str_view(tok->chunk + tok->pos, end - tok->pos); }
+    // only "\r\n" and a '\r' at the end of input are line ends, not '\r' before other delimiters
+    bool line_end = end == tok->len || tok->chunk[end] == '\n';
+    tok->pos = end < tok->len ? end +1 : end;
+
+    if (HAS_FLAG(tok->flags, STR_TOK_STRIP_CR) && line_end && t.len > 0 && t.ptr[t.len -1] == '\r') { t.len--; }
+    if (t.len == 0 && HAS_FLAG(tok->flags, STR_TOK_SKIP_EMPTY))
+    {
+      if (tok->carry_out) { tok->carry_len = 0; tok->carry_out = false; }
+      continue;
+    }
+    *token = t;
+    return true;
+  }
+}
+
+void str_tok_free(str_tok_t* tok)
+{
+  if (tok->carry != NULL) { FREE(tok->carry); }
+  tok->carry_len = 0;
+  tok->carry_cap = 0;
 }
 
 // https://www.delftstack.com/howto/c/truncate-string-in-c/
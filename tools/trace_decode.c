@@ -0,0 +1,85 @@
+// @DOC: decodes binary trace logs, written by TRACE_FLUSH() with TRACE_LOG_BINARY defined
+//       build: gcc tools/trace_decode.c -o trace_decode
+//       usage: trace_decode trace.log [--chrome]
+//       prints the same text TRACE_FLUSH() writes without TRACE_LOG_BINARY
+//       --chrome: prints chrome trace-event json instead, same as TRACE_EXPORT_CHROME()
+
+#include "../global.h"
+
+
+// @DOC: print msg, free the first count strings and close f, returns exit code for main()
+static int decode_fail(FILE* f, char** strings, u32 count, const char* msg)
+{
+  fputs(msg, stderr);
+  for (u32 i = 0; i < count; ++i) { free(strings[i]); }
+  free(strings);
+  fclose(f);
+  return 1;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s <trace log> [--chrome]\n", argv[0]);
+    return 1;
+  }
+  bool chrome = argc > 2 && strcmp(argv[2], "--chrome") == 0;
+
+  FILE* f = fopen(argv[1], "rb");
+  if (f == NULL)
+  {
+    fprintf(stderr, "couldnt open trace log: %s\n", argv[1]);
+    return 1;
+  }
+
+  trace_bin_header_t header;
+  if (fread(&header, sizeof(header), 1, f) != 1 || memcmp(header.magic, TRACE_BIN_MAGIC, 4) != 0)
+  {
+    fprintf(stderr, "%s isnt a binary trace log\n", argv[1]);
+    fclose(f);
+    return 1;
+  }
+  if (header.version != TRACE_BIN_VERSION)
+  {
+    fprintf(stderr, "trace log version is %u, can only decode version %u\n", header.version, TRACE_BIN_VERSION);
+    fclose(f);
+    return 1;
+  }
+
+  // string table
+  char** strings = (char**)calloc((size_t)header.string_count + 1, sizeof(char*));
+  if (strings == NULL) { fprintf(stderr, "trace log has too many strings: %u\n", header.string_count); fclose(f); return 1; }
+  for (u32 i = 0; i < header.string_count; ++i)
+  {
+    u32 len = 0;
+    if (fread(&len, sizeof(len), 1, f) != 1) { return decode_fail(f, strings, i, "trace log is truncated\n"); }
+    strings[i] = (char*)malloc((size_t)len + 1);
+    if (strings[i] == NULL) { return decode_fail(f, strings, i, "trace log is corrupt, string too long\n"); }
+    if (fread(strings[i], 1, len, f) != len) { return decode_fail(f, strings, i +1, "trace log is truncated\n"); }
+    strings[i][len] = '\0';
+  }
+
+  trace_bin_entry_t* entries = (trace_bin_entry_t*)malloc(sizeof(trace_bin_entry_t) * (size_t)header.entry_count);
+  if (entries == NULL && header.entry_count > 0) { return decode_fail(f, strings, header.string_count, "trace log is corrupt, too many entries\n"); }
+  u32 read = (u32)fread(entries, sizeof(trace_bin_entry_t), header.entry_count, f);
+  if (read != header.entry_count) { fprintf(stderr, "trace log is truncated\n"); header.entry_count = read; }
+  // ids index strings, so a corrupt or mismatched log would read out of bounds
+  for (u32 i = 0; i < header.entry_count; ++i)
+  {
+    if (entries[i].func >= header.string_count || entries[i].file >= header.string_count)
+    {
+      free(entries);
+      return decode_fail(f, strings, header.string_count, "trace log is corrupt, entry has invalid string id\n");
+    }
+  }
+
+  if (chrome) { trace_bin_write_chrome(stdout, &header, entries, (const char* const*)strings); }
+  else        { trace_bin_write_text(stdout, &header, entries, (const char* const*)strings); }
+
+  free(entries);
+  for (u32 i = 0; i < header.string_count; ++i) { free(strings[i]); }
+  free(strings);
+  fclose(f);
+  return 0;
+}